@@ -19,6 +19,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -28,6 +29,10 @@ extern "C" {
 typedef struct ENG_Renderer ENG_Renderer;
 typedef uint32_t ENG_TexID;   /* 0 = 無効 */
 typedef uint32_t ENG_FontID;  /* 0 = 無効 */
+typedef uint32_t ENG_PackID;  /* 0 = 無効 */
+typedef uint32_t ENG_PaletteID; /* 0 = 無効 */
+typedef uint32_t ENG_TextID;  /* 0 = 無効 */
+typedef uint32_t ENG_FaceID;  /* 0 = 無効 */
 
 /* ── キーコード (SDL_Scancodeと対応) ────────────────────*/
 typedef enum {
@@ -154,6 +159,61 @@ float eng_mouse_wheel(ENG_Renderer* r);
 /** FPS 上限を設定 (0=無制限, デフォルト=0) */
 void eng_set_fps_cap(ENG_Renderer* r, int fps);
 
+typedef enum {
+    ENG_PACE_SLEEP  = 0,  /* SDL_Delay だけ (CPU 負荷最小, ±1ms 程度ぶれる) */
+    ENG_PACE_HYBRID = 1,  /* 締切の少し手前まで寝て残りをスピン (既定) */
+    ENG_PACE_SPIN   = 2,  /* 全部スピン (最も正確, CPU を 1 コア使い切る) */
+} ENG_Pacing;
+
+/** FPS 上限まで待つ方法を設定 */
+void eng_set_pacing(ENG_Renderer* r, ENG_Pacing mode);
+
+typedef enum {
+    ENG_VSYNC_ADAPTIVE = -1,  /* 間に合えば VSync、遅れたフレームは待たずに出す (レイトスワップ) */
+    ENG_VSYNC_OFF      = 0,
+    ENG_VSYNC_ON       = 1,   /* 既定 */
+} ENG_VSync;
+
+/** VSync を設定。非対応なら false (ADAPTIVE が使えなければ ON になる) */
+bool eng_set_vsync(ENG_Renderer* r, ENG_VSync mode);
+
+/* 直近のフレーム時間 (スワップ間隔) の統計。窓は 240 フレーム */
+typedef struct {
+    int      frames;       /* 窓内のフレーム数 */
+    double   avg_ms;
+    double   p50_ms;
+    double   p95_ms;
+    double   p99_ms;
+    double   max_ms;
+    int      hitches;      /* 窓内のヒッチ (FPS 上限の周期、無ければ平均の 1.5 倍超) */
+    uint64_t hitch_total;  /* 起動からのヒッチ数 */
+} ENG_FrameStats;
+
+/** フレーム時間の統計を取得 (eng_fps も同じ窓の平均) */
+void eng_frame_stats(ENG_Renderer* r, ENG_FrameStats* out);
+
+/* ── 固定ステップ ───────────────────────────────────────*/
+/*
+ * 描画のフレームレートに関係なく、シミュレーションを一定周期で回すための時計。
+ *   while (eng_update(r)) {
+ *       for (int i = 0; i < eng_fixed_steps(r); ++i) step(eng_fixed_dt(r));
+ *       draw(eng_fixed_alpha(r));   // 前の状態と最新の状態を alpha で補間
+ *       eng_flush(r);
+ *   }
+ */
+
+/** 固定ステップを hz で有効にする (hz <= 0 で無効)。max_steps は 1 フレームに回す上限 (<= 0 で 5) */
+void   eng_set_fixed_step(ENG_Renderer* r, double hz, int max_steps);
+
+/** このフレームで回すステップ数 (eng_update ごとに決まる。上限を超えて遅れた分は捨てる) */
+int    eng_fixed_steps(ENG_Renderer* r);
+
+/** 1 ステップの秒数 */
+double eng_fixed_dt(ENG_Renderer* r);
+
+/** 描画の補間係数 0〜1 (最新のステップから次のステップまでの経過割合) */
+double eng_fixed_alpha(ENG_Renderer* r);
+
 /* ── クリッピング ───────────────────────────────────────*/
 
 /** この矩形外への描画をカット (UI ウィンドウなどに使用) */
@@ -162,6 +222,53 @@ void eng_clip_begin(ENG_Renderer* r, float x, float y, float w, float h);
 /** クリッピング解除 */
 void eng_clip_end(ENG_Renderer* r);
 
+/* ── 解像度スケール ─────────────────────────────────────*/
+
+/**
+ * 場面を (ウィンドウ × scale) の解像度で描いてからウィンドウへ拡大する (0.25〜1, 既定 1 = ネイティブ)。
+ * 座標・カメラ・マウスは論理ピクセルのまま。次のフレームから効き、自動調整は止まる。
+ */
+void   eng_set_render_scale(ENG_Renderer* r, float scale);
+
+/**
+ * 場面の GPU 時間から倍率を min_scale〜max_scale で自動調整し、target_fps を保つ。
+ * target_fps <= 0 で停止 (倍率はその時点のまま)。
+ */
+void   eng_set_render_scale_auto(ENG_Renderer* r, float target_fps, float min_scale, float max_scale);
+
+/** 拡大時のフィルタ。true = 最近傍 (ドット絵向け), false = 線形 (既定) */
+void   eng_set_render_scale_nearest(ENG_Renderer* r, bool nearest);
+
+/** 現在の倍率 */
+float  eng_render_scale(ENG_Renderer* r);
+
+/** 場面の GPU 時間 (ms, 平滑化済み。自動調整中だけ計測) */
+double eng_render_gpu_ms(ENG_Renderer* r);
+
+/**
+ * このフレームの場面を確定してウィンドウへ拡大し、以降の描画をネイティブ解像度で行う (UI 用)。
+ * 呼ばなければ eng_flush で拡大される。
+ */
+void   eng_begin_ui(ENG_Renderer* r);
+
+/* ── ブレンド ───────────────────────────────────────────*/
+
+/**
+ * 乗算済みアルファで描画する (デフォルト = false, 通常のアルファ)
+ * 有効にすると以降に読込む画像はロード時に RGB×A へ変換され、ブレンドは
+ * ONE, ONE_MINUS_SRC_ALPHA になる。加算合成と通常描画が同じバッチに入る。
+ * テクスチャを読込む前に設定すること (DDS/KTX の圧縮データは変換しない)
+ */
+void eng_set_premultiplied_alpha(ENG_Renderer* r, bool on);
+bool eng_premultiplied_alpha(ENG_Renderer* r);
+
+/**
+ * 以降の描画を加算合成にする (パーティクル・光など)
+ * 乗算済みモードでは頂点色で切り替えるためバッチは途切れない。
+ * 通常モードではブレンド関数を切り替える (フラッシュが発生する)
+ */
+void eng_set_additive(ENG_Renderer* r, bool on);
+
 /* ── 描画 (基本) ────────────────────────────────────────*/
 
 /** 画面をクリア (RGBA 各 0.0〜1.0) */
@@ -184,6 +291,194 @@ int       eng_tex_width(ENG_Renderer* r, ENG_TexID id);
 /** テクスチャの高さ (px) */
 int       eng_tex_height(ENG_Renderer* r, ENG_TexID id);
 
+/* ── テクスチャ形式 ─────────────────────────────────────*/
+/*
+ * DDS (DXT1/DXT5/DX10) と KTX 1.1 の BC1/BC3/BC7 は圧縮のまま GPU へ転送する。
+ * ドライバが非対応の場合、BC1/BC3 はソフトウェアで RGBA8 に展開する
+ * (BC7 はエラー)。通常の画像は RGB565 / RGBA4444 に変換して読込める。
+ */
+
+typedef enum {
+    ENG_TEXFMT_RGBA8    = 0,  /* 4 byte/px (デフォルト) */
+    ENG_TEXFMT_RGB565   = 1,  /* 2 byte/px, アルファなし */
+    ENG_TEXFMT_RGBA4444 = 2,  /* 2 byte/px */
+    ENG_TEXFMT_BC1      = 3,  /* 0.5 byte/px (DXT1) */
+    ENG_TEXFMT_BC3      = 4,  /* 1 byte/px (DXT5) */
+    ENG_TEXFMT_BC7      = 5,  /* 1 byte/px (BPTC) */
+    ENG_TEXFMT_INDEX8   = 6,  /* 1 byte/px, 256 色までのパレット参照 (GL_R8) */
+} ENG_TexFormat;
+
+typedef enum {
+    ENG_FILTER_NEAREST   = 0,  /* ドット絵向け (デフォルト) */
+    ENG_FILTER_LINEAR    = 1,  /* バイリニア (ミップ有りならレベル間は最近傍) */
+    ENG_FILTER_TRILINEAR = 2,  /* レベル間も補間 (ミップを自動で有効化) */
+} ENG_TexFilter;
+
+typedef enum {
+    ENG_WRAP_CLAMP  = 0,  /* 端のピクセルを延長 (デフォルト) */
+    ENG_WRAP_REPEAT = 1,
+    ENG_WRAP_MIRROR = 2,
+} ENG_TexWrap;
+
+/*
+ * mipmaps を有効にすると縮小描画 (eng_cam_zoom < 1 等) で小さいレベルから
+ * 読むため、キャッシュミスとエイリアシングが減る (VRAM は約 4/3 倍)。
+ * 同じ (filter, wrap, mipmaps) のテクスチャはサンプラーオブジェクトを共有する。
+ * ミップ付き / CLAMP 以外のテクスチャはアトラスに入らない。
+ */
+typedef struct {
+    ENG_TexFormat format;   /* 非圧縮画像の格納形式 (RGBA8 / RGB565 / RGBA4444) */
+    bool          async;    /* true = eng_load_texture_async と同様に非同期 */
+    bool          mipmaps;  /* ミップマップ生成 (DDS/KTX は同梱レベルを使用) */
+    ENG_TexFilter filter;
+    ENG_TexWrap   wrap;
+} ENG_TexParams;
+
+/** オプション付きで読込む (params = NULL でデフォルト) */
+ENG_TexID     eng_load_texture_ex(ENG_Renderer* r, const char* path,
+                                  const ENG_TexParams* params);
+
+/**
+ * 複数ファイルを一括で読込む (完了まで待つ)
+ * デコードはワーカー全スレッドで並列に行い、GL 転送は呼び出し元で順に行う。
+ * ids_out[i] に各 ID (失敗は 0) を書き、成功数を返す。params->async は無視。
+ */
+int           eng_load_textures(ENG_Renderer* r, const char* const* paths, int n,
+                                ENG_TexID* ids_out, const ENG_TexParams* params);
+
+/** GPU 上の格納形式 */
+ENG_TexFormat eng_tex_format(ENG_Renderer* r, ENG_TexID id);
+
+/** GPU 上の推定使用量 (byte, アトラス格納分を含む) */
+size_t        eng_tex_vram_bytes(ENG_Renderer* r, ENG_TexID id);
+
+/** ドライバがその形式を直接扱えるか */
+bool          eng_tex_format_supported(ENG_Renderer* r, ENG_TexFormat fmt);
+
+/* ── パレット (INDEX8 テクスチャ) ───────────────────────*/
+/*
+ * format = ENG_TEXFMT_INDEX8 で読込むと、画像の色 (256 色まで) がパレットに、
+ * 画素が 1 byte の番号になる (RGBA8 の 1/4)。パレットは共有テクスチャの 1 行で、
+ * 描画ごとに行を選べるので色違いを同じテクスチャ・同じバッチで描ける。
+ * INDEX8 は常に最近傍・ミップなしで読込む。
+ */
+
+/** INDEX8 テクスチャが読込時に作ったパレット (テクスチャ解放で一緒に消える) */
+ENG_PaletteID eng_tex_palette(ENG_Renderer* r, ENG_TexID id);
+
+/** RGBA8 × count 色 (≤256) からパレットを作成 (0 = エラー) */
+ENG_PaletteID eng_palette_create(ENG_Renderer* r, const unsigned char* rgba, int count);
+
+/**
+ * 色違い画像からパレットを作成
+ * base_path を INDEX8 にしたときの各番号に、同じ位置の variant_path の色を割当てる。
+ * 2 枚は同じ寸法であること
+ */
+ENG_PaletteID eng_palette_load_variant(ENG_Renderer* r, const char* base_path,
+                                       const char* variant_path);
+
+/** 1 色を書換える (index 0〜255, 色は 0.0〜1.0) */
+bool eng_palette_set_color(ENG_Renderer* r, ENG_PaletteID id, int index,
+                           float cr, float cg, float cb, float ca);
+
+/** eng_palette_create / eng_palette_load_variant で作ったパレットを削除 */
+void eng_palette_free(ENG_Renderer* r, ENG_PaletteID id);
+
+/** 以降の INDEX8 描画に使うパレット (0 = 各テクスチャ既定) */
+void eng_set_palette(ENG_Renderer* r, ENG_PaletteID id);
+
+/* ── 動的テクスチャ ─────────────────────────────────────*/
+/*
+ * 動画フレーム・手続き生成マップ・CPU 描画の UI など、毎フレーム内容が
+ * 変わる画像用。更新は PBO リング経由で転送するため glTexSubImage2D で
+ * 描画スレッドが GPU を待たない。
+ */
+
+/**
+ * 空のテクスチャを作成 (fmt = RGBA8 / RGB565 / RGBA4444 / INDEX8, 0 = エラー)。
+ * INDEX8 は番号 = 明るさの灰色のパレットを 1 行持ち、eng_tex_palette で取得して色を書換える
+ * (テクスチャ解放で一緒に消える)。
+ */
+ENG_TexID eng_texture_create(ENG_Renderer* r, int w, int h, ENG_TexFormat fmt);
+
+/**
+ * (x, y, w, h) の範囲を書き換える。pixels はテクスチャの形式で隙間なく
+ * 詰めた w×h 画素 (RGBA8 なら w*h*4 byte)。ファイル由来のテクスチャも
+ * アトラス格納・圧縮形式・読込中でなければ更新できる。
+ */
+bool      eng_texture_update(ENG_Renderer* r, ENG_TexID id,
+                             int x, int y, int w, int h, const void* pixels);
+
+/* ── テクスチャキャッシュ ───────────────────────────────*/
+/*
+ * eng_load_texture / eng_load_texture_async は同じパスを 2 回読込まず、
+ * 既存の ID を返して参照カウントを増やす。eng_free_texture は
+ * 参照カウントが 0 になった時点で GPU メモリを解放する。
+ */
+
+typedef struct {
+    int      textures;        /* 生存テクスチャ数 */
+    uint64_t cache_hits;      /* パスキャッシュのヒット数 */
+    uint64_t cache_misses;
+    double   hit_rate;        /* hits / (hits + misses) */
+    uint64_t resident_bytes;  /* GPU 上の推定使用量 */
+    double   upload_ms;       /* GL 転送に掛かった累計時間 */
+    uint64_t budget_bytes;    /* eng_set_texture_budget の値 (0 = 無制限) */
+    uint64_t evictions;       /* 予算超過で追い出した回数 */
+    uint64_t reloads;         /* 追い出し後に再読込できた回数 */
+} ENG_TexStats;
+
+/** テクスチャキャッシュの統計を取得 */
+void eng_tex_stats(ENG_Renderer* r, ENG_TexStats* out);
+
+/**
+ * テクスチャの VRAM 予算 (バイト, 0 = 無制限, デフォルト)。
+ * eng_update ごとに resident_bytes が予算を超えていれば、直近 2 フレームで
+ * 描かれていないテクスチャを古い順に GPU から追い出す。ID はそのまま有効で、
+ * 次に描いたときに元のファイル (非同期) またはパックから読み直す (失敗したら間隔を空けて再試行)。
+ * 読み直し中はプレースホルダーで描かれる。対象は読込元のある専用テクスチャのみ
+ * (アトラス上の画像・動的テクスチャ・eng_tex_create_rgba 相当・閉じたパックの画像は追い出さない)。
+ */
+void eng_set_texture_budget(ENG_Renderer* r, uint64_t bytes);
+
+/* ── 非同期テクスチャロード ─────────────────────────────*/
+
+typedef enum {
+    ENG_TEX_INVALID = 0,  /* 無効 ID / 解放済み / ロード失敗 */
+    ENG_TEX_PENDING = 1,  /* デコード中または GL 転送待ち */
+    ENG_TEX_READY   = 2,
+} ENG_TexStatus;
+
+/**
+ * ワーカースレッドでデコードを開始し、すぐに ID を返す (0 = エラー)。
+ * 完了までは透明なプレースホルダーで描画され、幅/高さは 0 を返す。
+ * GL への転送は eng_update 内で転送予算の範囲で行われる。
+ * ワーカーを使えないときはその場でデコードし、READY の ID を返す。
+ */
+ENG_TexID     eng_load_texture_async(ENG_Renderer* r, const char* path);
+
+/** テクスチャの読込状態 */
+ENG_TexStatus eng_tex_status(ENG_Renderer* r, ENG_TexID id);
+
+/** 読込中 (デコード中 + 転送待ち) のテクスチャ数 */
+int           eng_tex_pending_count(ENG_Renderer* r);
+
+/** 1 フレームあたりの GL 転送予算 (ミリ秒, デフォルト 2.0) */
+void          eng_set_upload_budget(ENG_Renderer* r, double ms);
+
+/* ── テクスチャアトラス ─────────────────────────────────*/
+
+/**
+ * 以降にロードする小さな画像 (ページの 1/4 辺以下) を共有ページに詰め込む。
+ *   page_size — 2048 / 4096 推奨 (0 = 無効, デフォルト)
+ * TexID・幅/高さ・UV 指定はそのまま使える。ただし UV はテクスチャ内
+ * (0.0〜1.0) に収めること (範囲外は隣の画像を参照する)。
+ */
+void eng_set_texture_atlas(ENG_Renderer* r, int page_size);
+
+/** 使用中のアトラスページ数 */
+int  eng_atlas_page_count(ENG_Renderer* r);
+
 /* ── スプライト描画 ─────────────────────────────────────*/
 
 /** テクスチャ全体を (x,y) に (w,h) のサイズで描画 */
@@ -259,29 +554,136 @@ void eng_draw_line(ENG_Renderer* r,
 /** フォントファイル (.ttf/.otf) をロードして ID を返す */
 ENG_FontID eng_load_font(ENG_Renderer* r, const char* path, float size);
 
+/**
+ * 距離場 (SDF) フォントをロードする。グリフは基準サイズで 1 回だけ作り、
+ * eng_draw_text_ex で任意のサイズ・回転・カメラズームでも輪郭が鋭いまま描ける。
+ * サイズごとにフォントを読む必要はない。size は eng_draw_text での既定サイズ。
+ */
+ENG_FontID eng_load_font_sdf(ENG_Renderer* r, const char* path, float size);
+
 /** システムデフォルトフォントをロード */
 ENG_FontID eng_load_font_default(ENG_Renderer* r, float size);
 
 /** フォントを解放する */
 void       eng_free_font(ENG_Renderer* r, ENG_FontID id);
 
-/** テキストを描画 */
+/*
+ * フェイス: TTF ファイル 1 つ分 (mmap したまま保持)。フォント ID はフェイス + サイズの
+ * インスタンスで、作成はほぼ無料。eng_load_font / eng_load_font_default も同じパスなら
+ * 自動的にフェイスを共有するので、同じファイルを別サイズで読んでも開き直さない。
+ */
+
+/** フェイスを開く (同じパスなら既存のものを返す)。使い終わったら eng_free_face */
+ENG_FaceID eng_load_face(ENG_Renderer* r, const char* path);
+
+/** フェイスから size px のフォントを作る */
+ENG_FontID eng_font_from_face(ENG_Renderer* r, ENG_FaceID face, float size);
+
+/** フェイスから SDF フォントを作る (eng_load_font_sdf と同じ) */
+ENG_FontID eng_font_from_face_sdf(ENG_Renderer* r, ENG_FaceID face, float size);
+
+/** フェイスの参照を手放す (作ったフォントが残っている間は閉じない。2 回目以降は何もしない) */
+void       eng_free_face(ENG_Renderer* r, ENG_FaceID face);
+
+/**
+ * グリフのディスクキャッシュを dir に置く (NULL = 無効、以後に作るフォントから有効)。
+ * フォントファイルの内容・サイズごとに、ラスタライズ済みの寸法と画素を保存し、
+ * 次回起動時は mmap から複写するだけで済ませる。フォントが変われば自動的に別キャッシュになる。
+ * 保存はフォント解放時 (eng_free_font / eng_destroy)。
+ */
+void       eng_set_font_cache_dir(ENG_Renderer* r, const char* dir);
+
+/**
+ * 新しい文字のラスタライズをワーカースレッドで行う (per_frame = 0 で描画スレッドでの同期に戻す)。
+ * 完成するまでその文字は描かれず (数フレーム遅れて現れる)、完成分は 1 フレーム
+ * per_frame 文字までキャッシュへ載せてまとめて転送する。会話で新しい漢字が一度に
+ * 大量に出てもフレームが詰まらない。テキストレイアウトは届いた時点で自動的に作り直す。
+ */
+void       eng_set_async_glyphs(ENG_Renderer* r, int per_frame);
+
+/** UTF-8 テキストを描画 (y はベースライン)。初めての文字はその場でグリフキャッシュへ作る */
 void eng_draw_text(ENG_Renderer* r, ENG_FontID fid,
                    const char* text,
                    float x, float y,
                    float cr, float cg, float cb, float ca);
 
+/**
+ * サイズ (px, 0 以下 = フォントの既定) と回転 (度, 原点 x,y まわり) を指定して描画。
+ * SDF フォント以外でも使えるが、拡大するとぼやける。幅は eng_text_width × size / 既定サイズ
+ */
+void eng_draw_text_ex(ENG_Renderer* r, ENG_FontID fid, const char* text,
+                      float x, float y, float size, float rot,
+                      float cr, float cg, float cb, float ca);
+
 /** テキストの描画幅 (px) を計算 */
 float eng_text_width(ENG_Renderer* r, ENG_FontID fid, const char* text);
 
 /** フォントの行高さ (px) を返す (ascent+descent+linegap 相当) */
 float eng_text_height(ENG_Renderer* r, ENG_FontID fid);
 
-/** テキストを最大幅 max_w に収まるよう自動折り返して描画する */
+/**
+ * テキストを最大幅 max_w に収まるよう自動折り返して描画する。
+ * 語単位 (空白の後、または CJK 文字の間) で折り返し、日本語の禁則処理を行う。
+ * 直前と同じ文字列・幅なら行分割を使い回すので、毎フレーム呼んでよい。
+ */
 void eng_draw_text_wrap(ENG_Renderer* r, ENG_FontID fid, const char* text,
                         float x, float y, float max_w,
                         float cr, float cg, float cb, float ca);
 
+/** eng_draw_text_wrap と同じ行分割での外接サイズ (max_w <= 0 なら改行文字のみで分割) */
+void eng_text_measure(ENG_Renderer* r, ENG_FontID fid, const char* text, float max_w,
+                      float* w, float* h);
+
+/* ── テキストレイアウト ─────────────────────────────────*/
+/*
+ * 変化の少ない文字列 (スコア表示・会話ウィンドウ) 向け。行分割とグリフ配置を
+ * 作成時に 1 回だけ行い、描画はバッチへの複写のみ。文字列を差し替えたときと、
+ * グリフキャッシュのページが追い出されたときだけ作り直す。
+ */
+
+typedef enum {
+    ENG_ALIGN_LEFT   = 0,
+    ENG_ALIGN_CENTER = 1,
+    ENG_ALIGN_RIGHT  = 2,
+} ENG_TextAlign;
+
+/** レイアウトを作成 (max_w > 0 で折り返し、揃えは max_w 幅 (0 なら最長行) 内で) */
+ENG_TextID eng_text_layout_create(ENG_Renderer* r, ENG_FontID font, const char* utf8,
+                                  float max_w, ENG_TextAlign align);
+
+/** 文字列を差し替える。前回と同じなら何もしない */
+bool       eng_text_layout_set_text(ENG_Renderer* r, ENG_TextID id, const char* utf8);
+
+/** (x, y) に描画。y は 1 行目のベースライン (eng_draw_text と同じ) */
+void       eng_text_layout_draw(ENG_Renderer* r, ENG_TextID id, float x, float y,
+                                float cr, float cg, float cb, float ca);
+
+/** 計測した外接サイズ (幅 = 最長行, 高さ = 行数 × 行間) */
+void       eng_text_layout_size(ENG_Renderer* r, ENG_TextID id, float* w, float* h);
+
+/** レイアウトを解放する */
+void       eng_text_layout_free(ENG_Renderer* r, ENG_TextID id);
+
+/* ── アセットパック ─────────────────────────────────────*/
+
+/**
+ * tools/eng_pack で作成したパック (.hjpk) を mmap で開く (0 = エラー)。
+ * 名前はパック作成時に指定したパスそのまま。
+ */
+ENG_PackID eng_pack_open(ENG_Renderer* r, const char* path);
+
+/** パックを閉じる (ロード済みのテクスチャ/フォントはそのまま使える。ID は開き直しても再利用されない) */
+void       eng_pack_close(ENG_Renderer* r, ENG_PackID pack);
+
+/** パックに名前のエントリがあるか */
+bool       eng_pack_contains(ENG_Renderer* r, ENG_PackID pack, const char* name);
+
+/** パック内のデコード済み画像からテクスチャを生成 */
+ENG_TexID  eng_pack_load_texture(ENG_Renderer* r, ENG_PackID pack, const char* name);
+
+/** パック内のフォントを読込 (同サイズのベイク済みアトラスがあればそれを使う) */
+ENG_FontID eng_pack_load_font(ENG_Renderer* r, ENG_PackID pack, const char* name, float size);
+
 /* ── カメラ ─────────────────────────────────────────────*/
 
 /** カメラ位置を設定 */
@@ -311,6 +713,53 @@ void eng_cam_screen_to_world(ENG_Renderer* r, float sx, float sy, float* wx, flo
 /** ワールド座標 → スクリーン座標に変換 */
 void eng_cam_world_to_screen(ENG_Renderer* r, float wx, float wy, float* sx, float* sy);
 
+typedef enum {
+    ENG_CAM_WORLD_TO_SCREEN = 0,
+    ENG_CAM_SCREEN_TO_WORLD = 1,
+} ENG_CamDir;
+
+/**
+ * n 点をまとめて変換する (in/out は x0,y0,x1,y1,... の 2n 要素、in == out 可)。
+ * 変換行列はカメラ変更時にだけ作り直され、ここでは SIMD で掛けるだけ。
+ */
+void eng_cam_transform_points(ENG_Renderer* r, const float* in, float* out, int n,
+                              ENG_CamDir dir);
+
+/* ── ビューポート (画面分割) ─────────────────────────────*/
+
+#define ENG_MAX_VIEWPORTS 8
+
+/**
+ * ビューポート idx (0〜ENG_MAX_VIEWPORTS-1) の画面上の矩形を設定する。
+ * w/h <= 0 でそのビューポートを無効化。カメラは設定し直すまで (0,0 / zoom=1 / rot=0)。
+ */
+bool eng_viewport_set(ENG_Renderer* r, int idx, float x, float y, float w, float h);
+
+/** ビューポート idx のカメラ (位置・ズーム・回転角[度], eng_cam_* と同じ意味) を設定 */
+void eng_viewport_cam(ENG_Renderer* r, int idx, float x, float y, float zoom, float degrees);
+
+/** 全ビューポートを無効化 */
+void eng_viewport_clear(ENG_Renderer* r);
+
+/**
+ * ワールド描画の記録を開始する。eng_viewport_end までの描画は GPU に送らず頂点を溜め、
+ * end で有効なビューポートごとに (矩形で切り抜き、そのカメラで) 再生する。
+ * 頂点の組み立てと転送は 1 回だけなので、ビューポート数が増えても CPU 側の負荷は変わらない。
+ * 間の eng_clip_begin はビューポート内の座標。eng_cam_* と eng_clear は効かない。
+ * 有効なビューポートが無ければ何もしない (通常どおり描く)。
+ */
+void eng_viewport_begin(ENG_Renderer* r);
+
+/** 記録を終えて各ビューポートに描き、画面全体 + 通常のカメラに戻す */
+void eng_viewport_end(ENG_Renderer* r);
+
+/** 画面座標 (sx, sy) を含むビューポート番号 (-1 = どれにも入らない) */
+int  eng_viewport_at(ENG_Renderer* r, float sx, float sy);
+
+/** 画面座標 → ビューポート idx のカメラでのワールド座標 (無効な idx は false) */
+bool eng_viewport_screen_to_world(ENG_Renderer* r, int idx, float sx, float sy,
+                                  float* wx, float* wy);
+
 /* ── ユーティリティ ─────────────────────────────────────*/
 
 /** フルスクリーン切替。fullscreen=true でボーダレスフルスクリーン。 */
@@ -0,0 +1,209 @@
+/**
+ * src/eng_atlas.c — 実行時テクスチャアトラス (スカイライン法)
+ *
+ * 小さな画像を共有ページ (2048² / 4096²) に詰め込み、
+ * 異なる TexID の描画でも同じ GL テクスチャでバッチできるようにする。
+ * 各画像の周囲には ENG_ATLAS_PAD px の境界ピクセルを複製して
+ * 隣接画像へのにじみを防ぐ。
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* ── スカイライン ───────────────────────────────────────*/
+/* idx 番目のノード左端に w×h を置いたときの y。置けなければ -1 */
+static int sky_fit(const ENG_AtlasPage* pg, int idx, int w, int h) {
+    int x = pg->sky[idx].x;
+    if (x + w > pg->size) return -1;
+    int y = pg->sky[idx].y;
+    int left = w;
+    for (int i = idx; left > 0; ++i) {
+        if (i >= pg->sky_count) return -1;
+        if (pg->sky[i].y > y) y = pg->sky[i].y;
+        if (y + h > pg->size) return -1;
+        left -= pg->sky[i].w;
+    }
+    return y;
+}
+
+static bool sky_insert(ENG_AtlasPage* pg, int w, int h, int* out_x, int* out_y) {
+    /* Bottom-Left: 最も低い y、同じなら最も狭いスカイラインを選ぶ */
+    int best = -1, best_y = pg->size + 1, best_w = pg->size + 1;
+    for (int i = 0; i < pg->sky_count; ++i) {
+        int y = sky_fit(pg, i, w, h);
+        if (y < 0) continue;
+        if (y + h < best_y || (y + h == best_y && pg->sky[i].w < best_w)) {
+            best = i; best_y = y + h; best_w = pg->sky[i].w;
+        }
+    }
+    if (best < 0) return false;
+
+    if (pg->sky_count + 1 > pg->sky_cap) {
+        int cap = pg->sky_cap ? pg->sky_cap * 2 : 64;
+        ENG_SkyNode* n = (ENG_SkyNode*)realloc(pg->sky, (size_t)cap * sizeof(ENG_SkyNode));
+        if (!n) return false;
+        pg->sky = n; pg->sky_cap = cap;
+    }
+
+    ENG_SkyNode node = { pg->sky[best].x, best_y, w };
+    memmove(&pg->sky[best + 1], &pg->sky[best],
+            (size_t)(pg->sky_count - best) * sizeof(ENG_SkyNode));
+    pg->sky[best] = node;
+    pg->sky_count++;
+
+    /* 新ノードに覆われた右側のノードを削る */
+    for (int i = best + 1; i < pg->sky_count; ++i) {
+        int shrink = (pg->sky[i-1].x + pg->sky[i-1].w) - pg->sky[i].x;
+        if (shrink <= 0) break;
+        pg->sky[i].x += shrink;
+        pg->sky[i].w -= shrink;
+        if (pg->sky[i].w > 0) break;
+        memmove(&pg->sky[i], &pg->sky[i + 1],
+                (size_t)(pg->sky_count - i - 1) * sizeof(ENG_SkyNode));
+        pg->sky_count--;
+        --i;
+    }
+    /* 同じ高さの隣接ノードを結合 */
+    for (int i = 0; i + 1 < pg->sky_count; ++i) {
+        if (pg->sky[i].y == pg->sky[i+1].y) {
+            pg->sky[i].w += pg->sky[i+1].w;
+            memmove(&pg->sky[i + 1], &pg->sky[i + 2],
+                    (size_t)(pg->sky_count - i - 2) * sizeof(ENG_SkyNode));
+            pg->sky_count--;
+            --i;
+        }
+    }
+
+    *out_x = node.x;
+    *out_y = node.y - h;
+    return true;
+}
+
+static void sky_reset(ENG_AtlasPage* pg) {
+    pg->sky_count = 1;
+    pg->sky[0].x = 0;
+    pg->sky[0].y = 0;
+    pg->sky[0].w = pg->size;
+}
+
+/* ── ページ生成 ─────────────────────────────────────────*/
+static ENG_AtlasPage* new_page(ENG_Atlas* a) {
+    if (a->page_count >= ENG_ATLAS_MAX_PAGES) return NULL;
+    ENG_AtlasPage* pg = &a->pages[a->page_count];
+    memset(pg, 0, sizeof(*pg));
+    pg->size = a->page_size;
+    pg->sky  = (ENG_SkyNode*)malloc(64 * sizeof(ENG_SkyNode));
+    if (!pg->sky) return NULL;
+    pg->sky_cap = 64;
+    sky_reset(pg);
+
+    glGenTextures(1, &pg->tex);
+    glBindTexture(GL_TEXTURE_2D, pg->tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, pg->size, pg->size, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    a->page_count++;
+    return pg;
+}
+
+/* ── 境界複製付きで転送 ─────────────────────────────────*/
+static bool blit_extruded(ENG_AtlasPage* pg, int x, int y,
+                          const unsigned char* rgba, int w, int h) {
+    const int P  = ENG_ATLAS_PAD;
+    int pw = w + P * 2, ph = h + P * 2;
+    uint32_t* buf = (uint32_t*)malloc((size_t)pw * (size_t)ph * 4);
+    if (!buf) return false;
+    const uint32_t* src = (const uint32_t*)rgba;
+    for (int py = 0; py < ph; ++py) {
+        int sy = py - P;
+        if (sy < 0) sy = 0; else if (sy >= h) sy = h - 1;
+        const uint32_t* row = src + (size_t)sy * (size_t)w;
+        uint32_t* dst = buf + (size_t)py * (size_t)pw;
+        for (int px = 0; px < P; ++px) {
+            dst[px]          = row[0];
+            dst[P + w + px]  = row[w - 1];
+        }
+        memcpy(dst + P, row, (size_t)w * 4);
+    }
+    glBindTexture(GL_TEXTURE_2D, pg->tex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, pw, ph,
+                    GL_RGBA, GL_UNSIGNED_BYTE, buf);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    free(buf);
+    return true;
+}
+
+/* ── 追加 / 解放 ────────────────────────────────────────*/
+bool eng_atlas_add(ENG_Renderer* r, const unsigned char* rgba, int w, int h,
+                   int* out_page, float* out_uv) {
+    ENG_Atlas* a = &r->atlas;
+    if (a->page_size <= 0 || w <= 0 || h <= 0) return false;
+    if (w > a->page_size / 4 || h > a->page_size / 4) return false;
+
+    const int P = ENG_ATLAS_PAD;
+    int x = 0, y = 0, page = -1;
+    for (int i = 0; i < a->page_count; ++i) {
+        if (a->pages[i].size != a->page_size) continue;
+        if (sky_insert(&a->pages[i], w + P * 2, h + P * 2, &x, &y)) { page = i; break; }
+    }
+    if (page < 0) {
+        ENG_AtlasPage* pg = new_page(a);
+        if (!pg || !sky_insert(pg, w + P * 2, h + P * 2, &x, &y)) return false;
+        page = a->page_count - 1;
+    }
+
+    ENG_AtlasPage* pg = &a->pages[page];
+    if (!blit_extruded(pg, x, y, rgba, w, h)) return false;
+    pg->live++;
+
+    float inv = 1.0f / (float)pg->size;
+    out_uv[0] = (float)(x + P) * inv;
+    out_uv[1] = (float)(y + P) * inv;
+    out_uv[2] = (float)(x + P + w) * inv;
+    out_uv[3] = (float)(y + P + h) * inv;
+    *out_page = page;
+    return true;
+}
+
+GLuint eng_atlas_page_tex(ENG_Renderer* r, int page) {
+    return r->atlas.pages[page].tex;
+}
+
+void eng_atlas_release(ENG_Renderer* r, int page) {
+    ENG_AtlasPage* pg = &r->atlas.pages[page];
+    /* スカイライン法は部分解放できないため、空になったページを丸ごと再利用 */
+    if (--pg->live <= 0) {
+        pg->live = 0;
+        sky_reset(pg);
+    }
+}
+
+void eng_atlas_shutdown(ENG_Renderer* r) {
+    ENG_Atlas* a = &r->atlas;
+    for (int i = 0; i < a->page_count; ++i) {
+        glDeleteTextures(1, &a->pages[i].tex);
+        free(a->pages[i].sky);
+    }
+    memset(a->pages, 0, sizeof(a->pages));
+    a->page_count = 0;
+}
+
+/* ── 公開 API ───────────────────────────────────────────*/
+void eng_set_texture_atlas(ENG_Renderer* r, int page_size) {
+    if (!r) return;
+    if (page_size <= 0) { r->atlas.page_size = 0; return; }
+    /* 2 の累乗に切り上げ (256〜8192) */
+    int s = 256;
+    while (s < page_size && s < 8192) s <<= 1;
+    r->atlas.page_size = s;
+}
+
+int eng_atlas_page_count(ENG_Renderer* r) {
+    return r ? r->atlas.page_count : 0;
+}
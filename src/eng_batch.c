@@ -16,22 +16,29 @@ void eng_clear(ENG_Renderer* r, float red, float green, float blue, float alpha)
 /* ── フラッシュ (フレーム末尾) ──────────────────────────*/
 void eng_flush(ENG_Renderer* r) {
     if (!r) return;
+    if (r->vp_recording) eng_viewport_end(r);  /* 閉じ忘れても記録分は描く */
     eng_batch_flush(r);
+    eng_scale_resolve(r);
     SDL_GL_SwapWindow(r->window);
+    eng_frame_swapped(r);
 }
 
 /* ── スプライト描画 ─────────────────────────────────────*/
+/* 0〜1 の UV をテクスチャのサブ矩形 (アトラス上の位置) に写像する */
+static inline float map_u(const ENG_TexRef* t, float u) { return t->u0 + (t->u1 - t->u0) * u; }
+static inline float map_v(const ENG_TexRef* t, float v) { return t->v0 + (t->v1 - t->v0) * v; }
+
 void eng_draw_sprite(ENG_Renderer* r, ENG_TexID id,
                      float x, float y, float w, float h) {
     if (!r || !id) return;
-    GLuint gl_id = eng_tex_gl_id(r, id);
-    if (!gl_id) return;
+    ENG_TexRef t;
+    if (!eng_tex_ref(r, id, &t)) return;
     eng_batch_push_quad(r,
         x, y, w, h,
-        0.0f, 0.0f, 1.0f, 1.0f,
+        t.u0, t.v0, t.u1, t.v1,
         0.0f, 0.0f, 0.0f,
         1.0f, 1.0f, 1.0f, 1.0f,
-        gl_id, true
+        &t
     );
 }
 
@@ -40,14 +47,14 @@ void eng_draw_sprite_ex(ENG_Renderer* r, ENG_TexID id,
                         float rot, float ox, float oy,
                         float cr, float cg, float cb, float ca) {
     if (!r || !id) return;
-    GLuint gl_id = eng_tex_gl_id(r, id);
-    if (!gl_id) return;
+    ENG_TexRef t;
+    if (!eng_tex_ref(r, id, &t)) return;
     eng_batch_push_quad(r,
         x, y, w, h,
-        0.0f, 0.0f, 1.0f, 1.0f,
+        t.u0, t.v0, t.u1, t.v1,
         rot, ox, oy,
         cr, cg, cb, ca,
-        gl_id, true
+        &t
     );
 }
 
@@ -55,14 +62,14 @@ void eng_draw_sprite_uv(ENG_Renderer* r, ENG_TexID id,
                         float x,  float y,  float w,  float h,
                         float u0, float v0, float u1, float v1) {
     if (!r || !id) return;
-    GLuint gl_id = eng_tex_gl_id(r, id);
-    if (!gl_id) return;
+    ENG_TexRef t;
+    if (!eng_tex_ref(r, id, &t)) return;
     eng_batch_push_quad(r,
         x, y, w, h,
-        u0, v0, u1, v1,
+        map_u(&t, u0), map_v(&t, v0), map_u(&t, u1), map_v(&t, v1),
         0.0f, 0.0f, 0.0f,
         1.0f, 1.0f, 1.0f, 1.0f,
-        gl_id, true
+        &t
     );
 }
 
@@ -72,14 +79,14 @@ void eng_draw_sprite_uv_ex(ENG_Renderer* r, ENG_TexID id,
                            float rot, float ox, float oy,
                            float cr, float cg, float cb, float ca) {
     if (!r || !id) return;
-    GLuint gl_id = eng_tex_gl_id(r, id);
-    if (!gl_id) return;
+    ENG_TexRef t;
+    if (!eng_tex_ref(r, id, &t)) return;
     eng_batch_push_quad(r,
         x, y, w, h,
-        u0, v0, u1, v1,
+        map_u(&t, u0), map_v(&t, v0), map_u(&t, u1), map_v(&t, v1),
         rot, ox, oy,
         cr, cg, cb, ca,
-        gl_id, true
+        &t
     );
 }
 
@@ -93,7 +100,7 @@ void eng_fill_rect(ENG_Renderer* r,
         0.0f, 0.0f, 1.0f, 1.0f,
         0.0f, 0.0f, 0.0f,
         cr, cg, cb, ca,
-        0, false
+        NULL
     );
 }
 
@@ -114,6 +121,7 @@ void eng_fill_circle(ENG_Renderer* r,
                      float cx, float cy, float radius,
                      float cr, float cg, float cb, float ca) {
     if (!r) return;
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
     int segs = 32;
     float step = (float)(2.0 * 3.14159265358979323846 / segs);
     for (int i = 0; i < segs; ++i) {
@@ -128,15 +136,15 @@ void eng_fill_circle(ENG_Renderer* r,
         /* 三角形を 縦幅0の四角形で近似（eng_fill_rectで代替） */
         /* 頂点を直接 push */
         ENG_Batch* b = &r->batch;
-        if (b->quad_count > 0 && b->use_tex) eng_batch_flush(r);
+        if (b->quad_count > 0 && b->mode != ENG_DRAW_COLOR) eng_batch_flush(r);
         if (b->quad_count >= ENG_MAX_BATCH) eng_batch_flush(r);
-        b->use_tex = false; b->current_tex = 0;
+        b->mode = ENG_DRAW_COLOR; b->current_tex = 0;
         int base = b->quad_count * 4;
         /* 縮退した4頂点 (p0, p1, p2, p2) */
-        b->verts[base+0] = (ENG_Vertex){x0,y0, 0,0, cr,cg,cb,ca};
-        b->verts[base+1] = (ENG_Vertex){x1,y1, 0,0, cr,cg,cb,ca};
-        b->verts[base+2] = (ENG_Vertex){x2,y2, 0,0, cr,cg,cb,ca};
-        b->verts[base+3] = (ENG_Vertex){x2,y2, 0,0, cr,cg,cb,ca};
+        b->verts[base+0] = (ENG_Vertex){x0,y0, 0,0, cr,cg,cb,ca, 0};
+        b->verts[base+1] = (ENG_Vertex){x1,y1, 0,0, cr,cg,cb,ca, 0};
+        b->verts[base+2] = (ENG_Vertex){x2,y2, 0,0, cr,cg,cb,ca, 0};
+        b->verts[base+3] = (ENG_Vertex){x2,y2, 0,0, cr,cg,cb,ca, 0};
         b->quad_count++;
     }
 }
@@ -169,16 +177,17 @@ void eng_draw_line(ENG_Renderer* r,
     float nx = -dy / len, ny = dx / len;
     float t = 1.0f; /* 線幅 1px */
     float hx = nx * t * 0.5f, hy = ny * t * 0.5f;
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
     /* 直線を薄い矩形に変換 */
     ENG_Batch* b = &r->batch;
-    if (b->quad_count > 0 && b->use_tex) eng_batch_flush(r);
+    if (b->quad_count > 0 && b->mode != ENG_DRAW_COLOR) eng_batch_flush(r);
     if (b->quad_count >= ENG_MAX_BATCH)  eng_batch_flush(r);
-    b->use_tex = false; b->current_tex = 0;
+    b->mode = ENG_DRAW_COLOR; b->current_tex = 0;
     int base = b->quad_count * 4;
-    b->verts[base+0] = (ENG_Vertex){x1+hx, y1+hy, 0,0, cr,cg,cb,ca};
-    b->verts[base+1] = (ENG_Vertex){x2+hx, y2+hy, 0,0, cr,cg,cb,ca};
-    b->verts[base+2] = (ENG_Vertex){x2-hx, y2-hy, 0,0, cr,cg,cb,ca};
-    b->verts[base+3] = (ENG_Vertex){x1-hx, y1-hy, 0,0, cr,cg,cb,ca};
+    b->verts[base+0] = (ENG_Vertex){x1+hx, y1+hy, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+1] = (ENG_Vertex){x2+hx, y2+hy, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+2] = (ENG_Vertex){x2-hx, y2-hy, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+3] = (ENG_Vertex){x1-hx, y1-hy, 0,0, cr,cg,cb,ca, 0};
     b->quad_count++;
 }
 
@@ -189,18 +198,18 @@ void eng_draw_sprite_flip(ENG_Renderer* r, ENG_TexID id,
                           float rot,
                           float cr, float cg, float cb, float ca) {
     if (!r || !id) return;
-    GLuint gl_id = eng_tex_gl_id(r, id);
-    if (!gl_id) return;
-    float u0 = flip_x ? 1.0f : 0.0f;
-    float u1 = flip_x ? 0.0f : 1.0f;
-    float v0 = flip_y ? 1.0f : 0.0f;
-    float v1 = flip_y ? 0.0f : 1.0f;
+    ENG_TexRef t;
+    if (!eng_tex_ref(r, id, &t)) return;
+    float u0 = flip_x ? t.u1 : t.u0;
+    float u1 = flip_x ? t.u0 : t.u1;
+    float v0 = flip_y ? t.v1 : t.v0;
+    float v1 = flip_y ? t.v0 : t.v1;
     eng_batch_push_quad(r,
         x, y, w, h,
         u0, v0, u1, v1,
         rot, 0.5f, 0.5f,
         cr, cg, cb, ca,
-        gl_id, true
+        &t
     );
 }
 
@@ -214,7 +223,7 @@ void eng_clip_begin(ENG_Renderer* r, float x, float y, float w, float h) {
     r->clip_w = (int)w;
     r->clip_h = (int)h;
     glEnable(GL_SCISSOR_TEST);
-    glScissor(r->clip_x, r->clip_y, r->clip_w, r->clip_h);
+    eng_gl_scissor(r, r->clip_x, r->clip_y, r->clip_w, r->clip_h);
 }
 
 void eng_clip_end(ENG_Renderer* r) {
@@ -224,21 +233,52 @@ void eng_clip_end(ENG_Renderer* r) {
     glDisable(GL_SCISSOR_TEST);
 }
 
+/* ── ブレンドモード ─────────────────────────────────────*/
+void eng_batch_blend(bool premul, bool additive) {
+    GLenum src = premul ? GL_ONE : GL_SRC_ALPHA;
+    GLenum dst = (additive && !premul) ? GL_ONE : GL_ONE_MINUS_SRC_ALPHA;
+    glBlendFunc(src, dst);
+}
+
+static void apply_blend(ENG_Renderer* r) {
+    eng_batch_blend(r->premul_alpha, r->additive);
+}
+
+void eng_set_premultiplied_alpha(ENG_Renderer* r, bool on) {
+    if (!r || r->premul_alpha == on) return;
+    eng_batch_flush(r);
+    r->premul_alpha = on;
+    apply_blend(r);
+}
+
+bool eng_premultiplied_alpha(ENG_Renderer* r) {
+    return r && r->premul_alpha;
+}
+
+void eng_set_additive(ENG_Renderer* r, bool on) {
+    if (!r || r->additive == on) return;
+    /* 乗算済みモードでは頂点色 (A = 0) で切り替わるのでフラッシュ不要 */
+    if (!r->premul_alpha) eng_batch_flush(r);
+    r->additive = on;
+    if (!r->premul_alpha) apply_blend(r);
+}
+
 /* ── 三角形 ─────────────────────────────────────────────*/
 void eng_fill_tri(ENG_Renderer* r,
                   float x0, float y0, float x1, float y1, float x2, float y2,
                   float cr, float cg, float cb, float ca) {
     if (!r) return;
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
     ENG_Batch* b = &r->batch;
-    if (b->quad_count > 0 && b->use_tex) eng_batch_flush(r);
+    if (b->quad_count > 0 && b->mode != ENG_DRAW_COLOR) eng_batch_flush(r);
     if (b->quad_count >= ENG_MAX_BATCH)  eng_batch_flush(r);
-    b->use_tex = false; b->current_tex = 0;
+    b->mode = ENG_DRAW_COLOR; b->current_tex = 0;
     /* 三角形を縮退四辺形として送る (v2=v3 で最後の三角形が縮退) */
     int base = b->quad_count * 4;
-    b->verts[base+0] = (ENG_Vertex){x0, y0, 0,0, cr,cg,cb,ca};
-    b->verts[base+1] = (ENG_Vertex){x1, y1, 0,0, cr,cg,cb,ca};
-    b->verts[base+2] = (ENG_Vertex){x2, y2, 0,0, cr,cg,cb,ca};
-    b->verts[base+3] = (ENG_Vertex){x2, y2, 0,0, cr,cg,cb,ca};
+    b->verts[base+0] = (ENG_Vertex){x0, y0, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+1] = (ENG_Vertex){x1, y1, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+2] = (ENG_Vertex){x2, y2, 0,0, cr,cg,cb,ca, 0};
+    b->verts[base+3] = (ENG_Vertex){x2, y2, 0,0, cr,cg,cb,ca, 0};
     b->quad_count++;
 }
 
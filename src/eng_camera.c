@@ -1,8 +1,19 @@
 /**
  * src/eng_camera.c — 2D カメラ制御
+ *
+ * ワールド ↔ スクリーンの変換行列は eng_update_proj のときだけ作り直し、
+ * 座標変換は掛け算だけで済ませる (多数の点は eng_cam_transform_points で SIMD 一括)。
  */
 #include "eng_internal.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define ENG_CAM_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define ENG_CAM_NEON 1
+#endif
+
 void eng_cam_pos(ENG_Renderer* r, float x, float y) {
     if (!r) return;
     r->cam_x = x; r->cam_y = y;
@@ -36,35 +47,77 @@ float eng_cam_get_x(ENG_Renderer* r)    { return r ? r->cam_x       : 0.0f; }
 float eng_cam_get_y(ENG_Renderer* r)    { return r ? r->cam_y       : 0.0f; }
 float eng_cam_get_zoom(ENG_Renderer* r) { return r ? r->cam_zoom    : 1.0f; }
 
+/* ── ビュー行列 ─────────────────────────────────────────*/
+/* 2x3 アフィン: out.x = m[0]*x + m[2]*y + m[4], out.y = m[1]*x + m[3]*y + m[5]
+ *   world→screen: s = z * R(-a) * (w - c)
+ *   screen→world: w = c + R(a) * s / z
+ * ただし s はスクリーン座標 (左上原点ピクセル)、c はカメラ位置 */
+void eng_cam_build_view(float cx, float cy, float zoom, float degrees, float* v, float* iv) {
+    float a  = degrees * (float)(3.14159265358979323846 / 180.0);
+    float ca = cosf(a), sa = sinf(a);
+    float z  = zoom > 0.001f ? zoom : 0.001f;
+    v[0] =  z * ca;  v[2] = z * sa;  v[4] = -z * (ca * cx + sa * cy);
+    v[1] = -z * sa;  v[3] = z * ca;  v[5] =  z * (sa * cx - ca * cy);
+    iv[0] = ca / z;  iv[2] = -sa / z;  iv[4] = cx;
+    iv[1] = sa / z;  iv[3] =  ca / z;  iv[5] = cy;
+}
+
+/* eng_update_proj から */
+void eng_cam_update_view(ENG_Renderer* r) {
+    eng_cam_build_view(r->cam_x, r->cam_y, r->cam_zoom, r->cam_rot_deg, r->view, r->view_inv);
+}
+
 /* ── 座標変換 ───────────────────────────────────────────*/
-/* 変換式の導出:
- *   world→NDC: NDC_x = (2z/W) * (ca*(wx-cx) + sa*(wy-cy)) - 1
- *   逆変換 (screen→world, rotation=a, zoom=z, cam=(cx,cy)):
- *     wx = cx + ca*(sx/z) - sa*(sy/z)
- *     wy = cy + sa*(sx/z) + ca*(sy/z)
- *   ただし sx = screen_x, sy = screen_y (左上原点ピクセル)
- */
 void eng_cam_screen_to_world(ENG_Renderer* r,
                               float sx, float sy,
                               float* wx, float* wy) {
     if (!r || !wx || !wy) return;
-    float a  = r->cam_rot_deg * (float)(3.14159265358979323846 / 180.0);
-    float ca = cosf(a), sa = sinf(a);
-    float z  = r->cam_zoom > 0.001f ? r->cam_zoom : 0.001f;
-    float px = sx / z;
-    float py = sy / z;
-    *wx = r->cam_x + ca * px - sa * py;
-    *wy = r->cam_y + sa * px + ca * py;
+    const float* m = r->view_inv;
+    *wx = m[0] * sx + m[2] * sy + m[4];
+    *wy = m[1] * sx + m[3] * sy + m[5];
 }
 
 void eng_cam_world_to_screen(ENG_Renderer* r,
                               float wx, float wy,
                               float* sx, float* sy) {
     if (!r || !sx || !sy) return;
-    float a  = r->cam_rot_deg * (float)(3.14159265358979323846 / 180.0);
-    float ca = cosf(a), sa = sinf(a);
-    float dx = wx - r->cam_x;
-    float dy = wy - r->cam_y;
-    *sx = (ca * dx + sa * dy) * r->cam_zoom;
-    *sy = (-sa * dx + ca * dy) * r->cam_zoom;
+    const float* m = r->view;
+    *sx = m[0] * wx + m[2] * wy + m[4];
+    *sy = m[1] * wx + m[3] * wy + m[5];
+}
+
+/* ── 一括変換 ───────────────────────────────────────────*/
+/* in/out は x0,y0,x1,y1,... (n 点)。in == out で上書きしてよい */
+void eng_cam_transform_points(ENG_Renderer* r, const float* in, float* out, int n,
+                              ENG_CamDir dir) {
+    if (!r || !in || !out || n <= 0) return;
+    const float* m = dir == ENG_CAM_SCREEN_TO_WORLD ? r->view_inv : r->view;
+    int i = 0;
+#if defined(ENG_CAM_SSE2)
+    /* 2 点ずつ: [x0 y0 x1 y1] → xx = [x0 x0 x1 x1], yy = [y0 y0 y1 y1] */
+    const __m128 ma = _mm_setr_ps(m[0], m[1], m[0], m[1]);
+    const __m128 mb = _mm_setr_ps(m[2], m[3], m[2], m[3]);
+    const __m128 mt = _mm_setr_ps(m[4], m[5], m[4], m[5]);
+    for (; i + 2 <= n; i += 2) {
+        __m128 v  = _mm_loadu_ps(in + i * 2);
+        __m128 xx = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 yy = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 o  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xx, ma), _mm_mul_ps(yy, mb)), mt);
+        _mm_storeu_ps(out + i * 2, o);
+    }
+#elif defined(ENG_CAM_NEON)
+    /* 4 点ずつ: x と y に分けて読み、分けたまま書く */
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t p = vld2q_f32(in + i * 2);
+        float32x4x2_t o;
+        o.val[0] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[4]), p.val[0], m[0]), p.val[1], m[2]);
+        o.val[1] = vmlaq_n_f32(vmlaq_n_f32(vdupq_n_f32(m[5]), p.val[0], m[1]), p.val[1], m[3]);
+        vst2q_f32(out + i * 2, o);
+    }
+#endif
+    for (; i < n; ++i) {
+        float x = in[i * 2], y = in[i * 2 + 1];
+        out[i * 2]     = m[0] * x + m[2] * y + m[4];
+        out[i * 2 + 1] = m[1] * x + m[3] * y + m[5];
+    }
 }
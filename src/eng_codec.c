@@ -0,0 +1,193 @@
+/**
+ * src/eng_codec.c — QOI / HJLZ (LZ4 圧縮 RGBA8) のデコード (GL 呼び出しなし)
+ *
+ * eng_image.c から呼ばれ、ワーカースレッドでも動く。形式は eng_codec_format.h。
+ *   QOI  — 1 画素 = 4 byte を 32bit 単位で書き込み、ラン長は一括で埋める
+ *   LZ4  — リテラル/マッチを 16 byte 単位でまとめて複写 (SSE2/NEON の
+ *          1 ロード + 1 ストアになる)。末尾付近だけ厳密に複写する
+ * 入力はすべて境界検査し、壊れたファイルでも範囲外アクセスしない。
+ */
+#include "eng_internal.h"
+#include "eng_codec_format.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define WILD 16  /* まとめて複写する単位 */
+
+static inline uint32_t rd32be(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/* ── QOI ────────────────────────────────────────────────*/
+unsigned char* eng_qoi_decode(const unsigned char* p, size_t n, int* w, int* h,
+                              const char** err) {
+    if (n < ENG_QOI_HEADER_SIZE + ENG_QOI_END_SIZE || memcmp(p, ENG_QOI_MAGIC, 4) != 0) {
+        *err = "QOI ヘッダーが不正";
+        return NULL;
+    }
+    uint32_t qw = rd32be(p + 4), qh = rd32be(p + 8);
+    if (qw == 0 || qh == 0 || qw > INT32_MAX || qh > INT32_MAX ||
+        (uint64_t)qw * qh > ENG_QOI_MAX_PIXELS || (p[12] != 3 && p[12] != 4)) {
+        *err = "QOI 画像サイズが不正";
+        return NULL;
+    }
+
+    size_t         npx = (size_t)qw * qh;
+    unsigned char* out = (unsigned char*)malloc(npx * 4);
+    if (!out) { *err = "メモリ不足"; return NULL; }
+
+    uint8_t  index[64][4];
+    uint8_t  px[4] = { 0, 0, 0, 255 };
+    uint32_t px32;
+    memset(index, 0, sizeof(index));
+    memcpy(&px32, px, 4);
+
+    const unsigned char* ip   = p + ENG_QOI_HEADER_SIZE;
+    const unsigned char* iend = p + n - ENG_QOI_END_SIZE;
+    unsigned char*       op   = out;
+    unsigned char*       oend = out + npx * 4;
+
+    while (op < oend) {
+        if (ip >= iend) { *err = "QOI データが不足"; goto fail; }
+        uint8_t b = *ip++;
+        if (b == ENG_QOI_OP_RGB) {
+            if (iend - ip < 3) { *err = "QOI データが不足"; goto fail; }
+            px[0] = ip[0]; px[1] = ip[1]; px[2] = ip[2];
+            ip += 3;
+        } else if (b == ENG_QOI_OP_RGBA) {
+            if (iend - ip < 4) { *err = "QOI データが不足"; goto fail; }
+            memcpy(px, ip, 4);
+            ip += 4;
+        } else {
+            switch (b & ENG_QOI_MASK) {
+            case ENG_QOI_OP_INDEX:
+                memcpy(px, index[b], 4);
+                break;
+            case ENG_QOI_OP_DIFF:
+                px[0] = (uint8_t)(px[0] + ((b >> 4) & 3) - 2);
+                px[1] = (uint8_t)(px[1] + ((b >> 2) & 3) - 2);
+                px[2] = (uint8_t)(px[2] + ( b       & 3) - 2);
+                break;
+            case ENG_QOI_OP_LUMA: {
+                if (ip >= iend) { *err = "QOI データが不足"; goto fail; }
+                uint8_t b2 = *ip++;
+                int     dg = (b & 0x3f) - 32;
+                px[0] = (uint8_t)(px[0] + dg - 8 + (b2 >> 4));
+                px[1] = (uint8_t)(px[1] + dg);
+                px[2] = (uint8_t)(px[2] + dg - 8 + (b2 & 0x0f));
+                break;
+            }
+            default: {  /* RUN: 直前の画素を繰り返す (index は更新済み) */
+                size_t run  = (size_t)(b & 0x3f) + 1;
+                size_t left = (size_t)(oend - op) / 4;
+                if (run > left) run = left;
+                for (size_t i = 0; i < run; ++i) memcpy(op + i * 4, &px32, 4);
+                op += run * 4;
+                continue;
+            }
+            }
+        }
+        memcpy(index[eng_qoi_hash(px[0], px[1], px[2], px[3])], px, 4);
+        memcpy(&px32, px, 4);
+        memcpy(op, &px32, 4);
+        op += 4;
+    }
+
+    *w = (int)qw;
+    *h = (int)qh;
+    return out;
+
+fail:
+    free(out);
+    return NULL;
+}
+
+/* ── LZ4 ブロック ───────────────────────────────────────*/
+/* 可変長の長さ (15 のとき 255 未満のバイトが来るまで加算) */
+static inline bool read_len(const unsigned char** ip, const unsigned char* iend, size_t* len) {
+    unsigned b;
+    do {
+        if (*ip >= iend) return false;
+        b = *(*ip)++;
+        *len += b;
+    } while (b == 255);
+    return true;
+}
+
+static inline void copy16(unsigned char* d, const unsigned char* s) {
+    memcpy(d, s, WILD);
+}
+
+bool eng_lz4_decompress(const unsigned char* src, size_t n, unsigned char* dst, size_t dst_size) {
+    const unsigned char* ip   = src;
+    const unsigned char* iend = src + n;
+    unsigned char*       op   = dst;
+    unsigned char*       oend = dst + dst_size;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+
+        /* リテラル */
+        size_t lit = token >> 4;
+        if (lit == 15 && !read_len(&ip, iend, &lit)) return false;
+        if (lit > (size_t)(iend - ip) || lit > (size_t)(oend - op)) return false;
+        if (lit <= WILD && (size_t)(iend - ip) >= WILD && (size_t)(oend - op) >= WILD) {
+            copy16(op, ip);  /* 短いリテラルは 1 回で (はみ出し分は後で上書き) */
+        } else {
+            memcpy(op, ip, lit);
+        }
+        ip += lit;
+        op += lit;
+        if (ip == iend) break;  /* 最後のシーケンスはリテラルのみ */
+
+        /* マッチ */
+        if (iend - ip < 2) return false;
+        size_t off = (size_t)ip[0] | ((size_t)ip[1] << 8);
+        ip += 2;
+        size_t len = token & 15;
+        if (len == 15 && !read_len(&ip, iend, &len)) return false;
+        len += ENG_LZ4_MIN_MATCH;
+        if (off == 0 || off > (size_t)(op - dst) || len > (size_t)(oend - op)) return false;
+
+        const unsigned char* m = op - off;
+        unsigned char*       e = op + len;
+        if (off >= WILD && (size_t)(oend - e) >= WILD) {
+            /* 重なりが 16 byte 以上離れていれば 16 byte 単位で安全に進められる */
+            do { copy16(op, m); op += WILD; m += WILD; } while (op < e);
+        } else {
+            while (op < e) *op++ = *m++;  /* 近距離の繰り返し (単色ランなど) */
+        }
+        op = e;
+    }
+    return op == oend;
+}
+
+/* ── HJLZ ───────────────────────────────────────────────*/
+unsigned char* eng_hjlz_decode(const unsigned char* p, size_t n, int* w, int* h,
+                               const char** err) {
+    ENG_HjlzHeader hdr;
+    if (n < sizeof(hdr)) { *err = "HJLZ ヘッダーが不正"; return NULL; }
+    memcpy(&hdr, p, sizeof(hdr));
+    if (hdr.magic != ENG_HJLZ_MAGIC || hdr.version != ENG_HJLZ_VERSION) {
+        *err = "HJLZ ヘッダーが不正";
+        return NULL;
+    }
+    if (hdr.width == 0 || hdr.height == 0 || hdr.width > INT32_MAX || hdr.height > INT32_MAX ||
+        (uint64_t)hdr.width * hdr.height > ENG_QOI_MAX_PIXELS) {
+        *err = "HJLZ 画像サイズが不正";
+        return NULL;
+    }
+    if (hdr.packed_size > n - sizeof(hdr)) { *err = "HJLZ データが不足"; return NULL; }
+
+    size_t         size = (size_t)hdr.width * hdr.height * 4;
+    unsigned char* out  = (unsigned char*)malloc(size);
+    if (!out) { *err = "メモリ不足"; return NULL; }
+    if (!eng_lz4_decompress(p + sizeof(hdr), (size_t)hdr.packed_size, out, size)) {
+        free(out);
+        *err = "HJLZ データが壊れています";
+        return NULL;
+    }
+    *w = (int)hdr.width;
+    *h = (int)hdr.height;
+    return out;
+}
@@ -0,0 +1,48 @@
+/**
+ * eng_codec_format.h — 高速デコード向け画像形式 (QOI / HJLZ)
+ *
+ * tools/eng_texconv.c (書き出し) と src/eng_codec.c (デコード) で共有する。
+ * どちらも PNG より数倍速く展開でき、eng_load_texture が先頭のマジックで判別する。
+ *
+ *   QOI  — https://qoiformat.org/qoi-specification.pdf そのまま (ヘッダーはビッグエンディアン)
+ *   HJLZ — RGBA8 の生画素を LZ4 ブロック形式で圧縮したもの (リトルエンディアン)
+ *            [ENG_HjlzHeader][LZ4 ブロック (packed_size byte)]
+ */
+#pragma once
+
+#include <stdint.h>
+
+/* ── QOI ────────────────────────────────────────────────*/
+#define ENG_QOI_MAGIC       "qoif"
+#define ENG_QOI_HEADER_SIZE 14
+#define ENG_QOI_END_SIZE    8          /* 終端 0,0,0,0,0,0,0,1 */
+#define ENG_QOI_MAX_PIXELS  400000000u /* 仕様上の上限 */
+
+#define ENG_QOI_OP_INDEX 0x00  /* 00xxxxxx */
+#define ENG_QOI_OP_DIFF  0x40  /* 01xxxxxx */
+#define ENG_QOI_OP_LUMA  0x80  /* 10xxxxxx */
+#define ENG_QOI_OP_RUN   0xc0  /* 11xxxxxx */
+#define ENG_QOI_OP_RGB   0xfe
+#define ENG_QOI_OP_RGBA  0xff
+#define ENG_QOI_MASK     0xc0
+
+static inline int eng_qoi_hash(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+    return (r * 3 + g * 5 + b * 7 + a * 11) & 63;
+}
+
+/* ── HJLZ (LZ4 圧縮 RGBA8) ──────────────────────────────*/
+#define ENG_HJLZ_MAGIC   0x5A4C4A48u   /* "HJLZ" */
+#define ENG_HJLZ_VERSION 1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width, height;
+    uint64_t packed_size;      /* 後続の LZ4 ブロック長 */
+} ENG_HjlzHeader;              /* 24 bytes, 展開後は width × height × 4 */
+
+/* LZ4 ブロック形式の制約 (エンコーダ側で守る) */
+#define ENG_LZ4_MIN_MATCH    4
+#define ENG_LZ4_LAST_LITERALS 5    /* 末尾 5 byte は必ずリテラル */
+#define ENG_LZ4_MF_LIMIT     12    /* 最後のマッチは末尾 12 byte より前で始まる */
+#define ENG_LZ4_MAX_OFFSET   65535
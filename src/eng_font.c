@@ -1,8 +1,15 @@
 /**
  * src/eng_font.c — フォント描画 (stb_truetype)
  *
- * ASCII + 基本ラテン / ラテン補完 文字をサポート。
- * 日本語等は将来バージョンで対応予定。
+ * 文字列は UTF-8。TTF フォントは事前ベイクせず、描いた文字だけを
+ * stbtt_MakeCodepointBitmap でグリフキャッシュ (eng_glyph.c) へ描き込む。
+ * CJK フォント全体を読んでも、VRAM を使うのは実際に表示した文字だけ。
+ * SDF フォント (eng_load_font_sdf) は距離場を ENG_SDF_BASE_SIZE で 1 回だけ作り、
+ * eng_draw_text_ex で任意のサイズ・回転に拡大縮小してもシェーダーで輪郭を鋭く保つ。
+ * TTF 本体と stbtt_fontinfo はフェイス (ENG_FontFace) が 1 つだけ持ち、ファイルは mmap する。
+ * フォント ID はフェイス + サイズの軽いインスタンスで、同じファイルを別サイズで
+ * 読んでもファイルは開き直さない。フェイスは参照数で、最後のフォントと一緒に閉じる。
+ * アセットパックのベイク済みフォントは ASCII 32〜127 のみ。
  */
 #define STB_TRUETYPE_IMPLEMENTATION
 #include "stb_truetype.h"
@@ -12,54 +19,24 @@
 #include <string.h>
 #include <stdio.h>
 
-/* ── フォントロード ─────────────────────────────────────*/
-ENG_FontID eng_load_font(ENG_Renderer* r, const char* path, float size) {
-    if (!r || !path) return 0;
-
-    /* 空きスロット */
-    int slot = -1;
-    for (int i = 0; i < ENG_MAX_FONTS; ++i) {
-        if (!r->fonts[i].used) { slot = i; break; }
-    }
-    if (slot < 0) {
-        fprintf(stderr, "[eng_render] フォントスロット不足\n");
-        return 0;
-    }
-
-    /* TTF ファイル読み込み */
-    FILE* f = fopen(path, "rb");
-    if (!f) {
-        fprintf(stderr, "[eng_render] フォント読み込み失敗: %s\n", path);
-        return 0;
-    }
-    fseek(f, 0, SEEK_END);
-    long fsz = ftell(f);
-    fseek(f, 0, SEEK_SET);
-    unsigned char* ttf_buf = (unsigned char*)malloc((size_t)fsz);
-    if (!ttf_buf) { fclose(f); return 0; }
-    if (fread(ttf_buf, 1, (size_t)fsz, f) < (size_t)fsz) {
-        free(ttf_buf); fclose(f); return 0;
-    }
-    fclose(f);
-
-    /* アトラスベイク (ASCII 32〜127) */
-    unsigned char* atlas_pix = (unsigned char*)calloc(
-        ENG_FONT_ATLAS_W * ENG_FONT_ATLAS_H, 1);
-    stbtt_bakedchar* baked = (stbtt_bakedchar*)malloc(96 * sizeof(stbtt_bakedchar));
-    if (!atlas_pix || !baked) {
-        free(ttf_buf); free(atlas_pix); free(baked);
-        return 0;
-    }
+/* ── エントリ参照 (解放済み・世代違いの ID は NULL) ────*/
+static inline ENG_FontEntry* font_get(ENG_Renderer* r, ENG_FontID id) {
+    return r ? (ENG_FontEntry*)eng_slots_get(&r->fonts, id) : NULL;
+}
 
-    int ret = stbtt_BakeFontBitmap(
-        ttf_buf, 0, size,
-        atlas_pix, ENG_FONT_ATLAS_W, ENG_FONT_ATLAS_H,
-        32, 96, baked);
-    free(ttf_buf);
+ENG_FontEntry* eng_font_get(ENG_Renderer* r, ENG_FontID id) {
+    return font_get(r, id);
+}
 
-    if (ret <= 0) {
-        fprintf(stderr, "[eng_render] フォントベイク失敗 (解像度を下げてください)\n");
-        free(atlas_pix); free(baked);
+/* ── ベイク済みアトラスを GL に転送して登録 ────────────*/
+/* baked の所有権はフォントエントリに移る */
+static ENG_FontID register_font(ENG_Renderer* r, float size,
+                                const unsigned char* atlas_pix, int aw, int ah,
+                                stbtt_bakedchar* baked) {
+    ENG_FontID id = eng_slots_alloc(&r->fonts);
+    if (!id) {
+        fprintf(stderr, "[eng_render] フォントを確保できません\n");
+        free(baked);
         return 0;
     }
 
@@ -67,9 +44,10 @@ ENG_FontID eng_load_font(ENG_Renderer* r, const char* path, float size) {
     GLuint tex;
     glGenTextures(1, &tex);
     glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED,
-                 ENG_FONT_ATLAS_W, ENG_FONT_ATLAS_H,
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, aw, ah,
                  0, GL_RED, GL_UNSIGNED_BYTE, atlas_pix);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -78,21 +56,212 @@ ENG_FontID eng_load_font(ENG_Renderer* r, const char* path, float size) {
     GLint swz[4] = {GL_RED, GL_RED, GL_RED, GL_RED};
     glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swz);
     glBindTexture(GL_TEXTURE_2D, 0);
-    free(atlas_pix);
 
-    r->fonts[slot].atlas_tex = tex;
-    r->fonts[slot].size      = size;
-    r->fonts[slot].baked     = baked;
-    r->fonts[slot].used      = true;
-    r->font_count++;
+    ENG_FontEntry* fe = font_get(r, id);
+    fe->atlas_tex = tex;
+    fe->atlas_w   = aw;
+    fe->atlas_h   = ah;
+    fe->size      = size;
+    fe->baked     = baked;
+    return id;
+}
+
+/* ── フェイス (TTF 本体 + stbtt_fontinfo を 1 つだけ持つ) ─*/
+static inline ENG_FontFace* face_get(ENG_Renderer* r, ENG_FaceID id) {
+    return r ? (ENG_FontFace*)eng_slots_get(&r->faces, id) : NULL;
+}
+
+static void face_destroy(ENG_FontFace* fc) {
+    eng_file_unmap(&fc->map);
+    free(fc->owned);
+    free(fc->info);
+    free(fc->path);
+}
+
+static void face_release(ENG_Renderer* r, ENG_FaceID id) {
+    ENG_FontFace* fc = face_get(r, id);
+    if (!fc || --fc->refs > 0) return;
+    face_destroy(fc);
+    eng_slots_free(&r->faces, id);
+}
+
+/* data は fc->map か fc->owned を指す。失敗時は呼び出し側が face_destroy する */
+static bool face_init(ENG_FontFace* fc, const unsigned char* data) {
+    fc->info   = malloc(sizeof(stbtt_fontinfo));
+    int offset = stbtt_GetFontOffsetForIndex(data, 0);  /* .ttc は先頭のフェイス */
+    if (!fc->info || offset < 0 || !stbtt_InitFont((stbtt_fontinfo*)fc->info, data, offset)) {
+        fprintf(stderr, "[eng_render] フォントデータが不正です%s%s\n",
+                fc->path ? ": " : "", fc->path ? fc->path : "");
+        return false;
+    }
+    fc->refs = 1;
+    return true;
+}
+
+/* 同じパスのフェイスがあれば参照を増やして返す。無ければ mmap して作る */
+static ENG_FaceID face_open(ENG_Renderer* r, const char* path) {
+    for (int i = 0; i < r->faces.cap; ++i) {
+        ENG_FaceID    id = eng_slots_id_at(&r->faces, i);
+        ENG_FontFace* fc = face_get(r, id);
+        if (fc && fc->path && strcmp(fc->path, path) == 0) {
+            fc->refs++;
+            return id;
+        }
+    }
+
+    ENG_FontFace tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    if (!eng_file_map(path, &tmp.map)) {
+        fprintf(stderr, "[eng_render] フォント読み込み失敗: %s\n", path);
+        return 0;
+    }
+    size_t len = strlen(path);
+    tmp.path = (char*)malloc(len + 1);
+    if (tmp.path) memcpy(tmp.path, path, len + 1);
+    if (!tmp.path || !face_init(&tmp, tmp.map.data)) { face_destroy(&tmp); return 0; }
+
+    ENG_FaceID id = eng_slots_alloc(&r->faces);
+    if (!id) {
+        fprintf(stderr, "[eng_render] フェイスを確保できません\n");
+        face_destroy(&tmp);
+        return 0;
+    }
+    *face_get(r, id) = tmp;
+    return id;
+}
+
+/* メモリ上の TTF (パック) から。同じ内容のフェイスがあれば共有し、無ければ複製して持つ */
+static ENG_FaceID face_from_memory(ENG_Renderer* r, const unsigned char* ttf, size_t len) {
+    for (int i = 0; i < r->faces.cap; ++i) {
+        ENG_FaceID    id = eng_slots_id_at(&r->faces, i);
+        ENG_FontFace* fc = face_get(r, id);
+        if (fc && fc->owned && fc->size == len && memcmp(fc->owned, ttf, len) == 0) {
+            fc->refs++;
+            return id;
+        }
+    }
+
+    ENG_FontFace tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    /* 呼び出し元 (パック) の領域は先に閉じられうるので複製して持つ */
+    tmp.owned = (unsigned char*)malloc(len);
+    if (!tmp.owned) return 0;
+    memcpy(tmp.owned, ttf, len);
+    tmp.size = len;
+    if (!face_init(&tmp, tmp.owned)) { face_destroy(&tmp); return 0; }
+
+    ENG_FaceID id = eng_slots_alloc(&r->faces);
+    if (!id) {
+        fprintf(stderr, "[eng_render] フェイスを確保できません\n");
+        face_destroy(&tmp);
+        return 0;
+    }
+    *face_get(r, id) = tmp;
+    return id;
+}
+
+/* ── TTF フォント = フェイス + サイズ (グリフは描画時に作る) ─*/
+static ENG_FontID create_instance(ENG_Renderer* r, ENG_FaceID face, float size, bool sdf) {
+    ENG_FontFace* fc = face_get(r, face);
+    if (!fc || size <= 0.0f) return 0;
+    ENG_FontID id = eng_slots_alloc(&r->fonts);
+    if (!id) {
+        fprintf(stderr, "[eng_render] フォントを確保できません\n");
+        return 0;
+    }
+    fc->refs++;
+    ENG_FontEntry* fe = font_get(r, id);
+    fe->self  = id;
+    fe->size  = size;
+    fe->face  = face;
+    fe->info  = fc->info;
+    fe->sdf   = sdf;
+    /* ベイク時と同じ基準 (SDF はサイズによらず共通の基準で作る) */
+    fe->scale = stbtt_ScaleForPixelHeight((const stbtt_fontinfo*)fc->info,
+                                          sdf ? ENG_SDF_BASE_SIZE : size);
+    if (r->font_cache_dir) {
+        if (!fc->hash) fc->hash = fc->owned ? eng_fontcache_hash(fc->owned, fc->size)
+                                            : eng_fontcache_hash(fc->map.data, fc->map.size);
+        fe->face_hash = fc->hash;
+        eng_fontcache_open(r, fe);
+    }
+    return id;
+}
+
+ENG_FontID eng_font_create_ttf(ENG_Renderer* r, const unsigned char* ttf, size_t len, float size) {
+    ENG_FaceID face = face_from_memory(r, ttf, len);
+    ENG_FontID id   = create_instance(r, face, size, false);
+    face_release(r, face);  /* 以降はフォントが参照を持つ */
+    return id;
+}
+
+/* 呼び出し元の参照はフェイスごとに 1 つだけ。2 回目以降は同じ ID を返すだけ */
+ENG_FaceID eng_load_face(ENG_Renderer* r, const char* path) {
+    if (!r || !path) return 0;
+    ENG_FaceID    id = face_open(r, path);
+    ENG_FontFace* fc = face_get(r, id);
+    if (!fc) return 0;
+    if (fc->api_ref) fc->refs--;
+    fc->api_ref = true;
+    return id;
+}
+
+ENG_FontID eng_font_from_face(ENG_Renderer* r, ENG_FaceID face, float size) {
+    return create_instance(r, face, size, false);
+}
 
-    return (ENG_FontID)(slot + 1);
+ENG_FontID eng_font_from_face_sdf(ENG_Renderer* r, ENG_FaceID face, float size) {
+    return create_instance(r, face, size, true);
+}
+
+/* 手放すのは eng_load_face の参照だけ。二重解放でフォントの参照を奪わない */
+void eng_free_face(ENG_Renderer* r, ENG_FaceID face) {
+    ENG_FontFace* fc = face_get(r, face);
+    if (!fc || !fc->api_ref) return;
+    fc->api_ref = false;
+    face_release(r, face);
+}
+
+/* ── ベイク済みデータから生成 (アセットパック用) ───────*/
+ENG_FontID eng_font_create_baked(ENG_Renderer* r, float size,
+                                 const unsigned char* atlas_pix, int aw, int ah,
+                                 const ENG_PackGlyph* glyphs) {
+    _Static_assert(sizeof(ENG_PackGlyph) == sizeof(stbtt_bakedchar),
+                   "ENG_PackGlyph と stbtt_bakedchar のレイアウト不一致");
+    stbtt_bakedchar* baked = (stbtt_bakedchar*)malloc(96 * sizeof(stbtt_bakedchar));
+    if (!baked) return 0;
+    memcpy(baked, glyphs, 96 * sizeof(stbtt_bakedchar));
+    return register_font(r, size, atlas_pix, aw, ah, baked);
+}
+
+/* ── フォントロード ─────────────────────────────────────*/
+/* 同じファイルのフォントはフェイスを共有し、サイズ違いでも読み直さない */
+static ENG_FontID load_font_file(ENG_Renderer* r, const char* path, float size, bool sdf) {
+    if (!r || !path) return 0;
+    ENG_FaceID face = face_open(r, path);
+    ENG_FontID id   = create_instance(r, face, size, sdf);
+    face_release(r, face);
+    return id;
+}
+
+ENG_FontID eng_load_font(ENG_Renderer* r, const char* path, float size) {
+    return load_font_file(r, path, size, false);
+}
+
+ENG_FontID eng_load_font_sdf(ENG_Renderer* r, const char* path, float size) {
+    return load_font_file(r, path, size, true);
 }
 
 /* ── システムフォント ───────────────────────────────────*/
 ENG_FontID eng_load_font_default(ENG_Renderer* r, float size) {
-    /* macOS */
+    /* スクリプトは日本語なので CJK を含むフォントを優先 (macOS / Windows / Linux) */
     const char* candidates[] = {
+        "/System/Library/Fonts/ヒラギノ角ゴシック W3.ttc",
+        "C:\\Windows\\Fonts\\meiryo.ttc",
+        "C:\\Windows\\Fonts\\msgothic.ttc",
+        "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc",
+        "/usr/share/fonts/noto-cjk/NotoSansCJK-Regular.ttc",
+        "/usr/share/fonts/google-noto-cjk/NotoSansCJK-Regular.ttc",
         "/System/Library/Fonts/Supplemental/Arial.ttf",
         "/Library/Fonts/Arial.ttf",
         "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
@@ -109,118 +278,391 @@ ENG_FontID eng_load_font_default(ENG_Renderer* r, float size) {
 }
 
 /* ── フォント解放 ───────────────────────────────────────*/
+static void release_font(ENG_Renderer* r, ENG_FontEntry* fe) {
+    if (fe->atlas_tex) glDeleteTextures(1, &fe->atlas_tex);
+    free(fe->baked);
+    if (fe->face_hash) eng_fontcache_close(r, fe);  /* グリフ表とフェイスを使うので先に */
+    free(fe->glyphs);
+    if (fe->face) face_release(r, fe->face);
+}
+
 void eng_free_font(ENG_Renderer* r, ENG_FontID id) {
-    if (!r || id == 0) return;
-    int slot = (int)id - 1;
-    if (slot < 0 || slot >= ENG_MAX_FONTS) return;
-    if (!r->fonts[slot].used) return;
-    glDeleteTextures(1, &r->fonts[slot].atlas_tex);
-    free(r->fonts[slot].baked);
-    memset(&r->fonts[slot], 0, sizeof(r->fonts[slot]));
-    r->font_count--;
+    ENG_FontEntry* fe = font_get(r, id);
+    if (!fe) return;
+    release_font(r, fe);  /* キャッシュ上のグリフはページ破棄時に上書きされる */
+    eng_slots_free(&r->fonts, id);
 }
 
-/* ── テキスト描画 ───────────────────────────────────────*/
-void eng_draw_text(ENG_Renderer* r, ENG_FontID fid,
-                   const char* text,
-                   float x, float y,
-                   float cr, float cg, float cb, float ca) {
-    if (!r || fid == 0 || !text) return;
-    int slot = (int)fid - 1;
-    if (slot < 0 || slot >= ENG_MAX_FONTS || !r->fonts[slot].used) return;
-
-    ENG_FontEntry*   fe    = &r->fonts[slot];
-    stbtt_bakedchar* baked = (stbtt_bakedchar*)fe->baked;
-    GLuint           gl_id = fe->atlas_tex;
-    float aw = (float)ENG_FONT_ATLAS_W;
-    float ah = (float)ENG_FONT_ATLAS_H;
-
-    float cx2 = x, cy2 = y;
-    for (const char* p = text; *p; ++p) {
-        unsigned char c = (unsigned char)*p;
-        if (c < 32 || c >= 128) {
-            cx2 += fe->size * 0.5f;
-            continue;
+/* ── 初期化 / 終了処理 (eng_create / eng_destroy から) ─*/
+void eng_font_init(ENG_Renderer* r) {
+    eng_slots_init(&r->fonts, sizeof(ENG_FontEntry));
+    eng_slots_init(&r->faces, sizeof(ENG_FontFace));
+}
+
+static void glyph_job_free(struct ENG_GlyphJob* j);
+
+void eng_font_shutdown(ENG_Renderer* r) {
+    /* ワーカーは eng_tex_shutdown で止まっている。載せ待ちの分はフェイス参照ごと捨てる */
+    for (int i = 0; i < r->glyph_ready_count; ++i) glyph_job_free(r->glyph_ready[i]);
+    free(r->glyph_ready);
+    r->glyph_ready       = NULL;
+    r->glyph_ready_count = r->glyph_ready_cap = 0;
+    for (int i = 0; i < r->fonts.cap; ++i) {
+        ENG_FontEntry* fe = font_get(r, eng_slots_id_at(&r->fonts, i));
+        if (fe) release_font(r, fe);
+    }
+    eng_slots_destroy(&r->fonts);
+    for (int i = 0; i < r->faces.cap; ++i) {  /* eng_free_face されていない分 */
+        ENG_FontFace* fc = face_get(r, eng_slots_id_at(&r->faces, i));
+        if (fc) face_destroy(fc);
+    }
+    eng_slots_destroy(&r->faces);
+    free(r->font_cache_dir);
+    r->font_cache_dir = NULL;
+    eng_glyph_shutdown(r);
+}
+
+/* ── グリフ表 (コードポイント → ENG_Glyph) ─────────────*/
+static inline uint32_t cp_hash(uint32_t cp) { return cp * 2654435761u; }
+
+static bool glyphs_grow(ENG_FontEntry* fe) {
+    int cap = fe->glyph_cap ? fe->glyph_cap * 2 : 256;
+    ENG_Glyph* g = (ENG_Glyph*)calloc((size_t)cap, sizeof(ENG_Glyph));
+    if (!g) return false;
+    for (int i = 0; i < fe->glyph_cap; ++i) {
+        if (!fe->glyphs[i].cp) continue;
+        uint32_t j = cp_hash(fe->glyphs[i].cp) & (uint32_t)(cap - 1);
+        while (g[j].cp) j = (j + 1) & (uint32_t)(cap - 1);
+        g[j] = fe->glyphs[i];
+    }
+    free(fe->glyphs);
+    fe->glyphs    = g;
+    fe->glyph_cap = cap;
+    return true;
+}
+
+/* 表にあるものだけ引く (無ければ NULL) */
+static ENG_Glyph* glyph_lookup(ENG_FontEntry* fe, uint32_t cp) {
+    if (!fe->glyph_cap) return NULL;
+    uint32_t mask = (uint32_t)fe->glyph_cap - 1;
+    for (uint32_t j = cp_hash(cp) & mask; fe->glyphs[j].cp; j = (j + 1) & mask) {
+        if (fe->glyphs[j].cp == cp) return &fe->glyphs[j];
+    }
+    return NULL;
+}
+
+/* 寸法だけを引く (初回は hmtx とビットマップ枠を読む。画素はまだ作らない) */
+static ENG_Glyph* glyph_find(ENG_FontEntry* fe, uint32_t cp) {
+    ENG_Glyph* found = glyph_lookup(fe, cp);
+    if (found) return found;
+    if ((fe->glyph_count + 1) * 4 > fe->glyph_cap * 3 && !glyphs_grow(fe)) return NULL;
+
+    uint32_t mask = (uint32_t)fe->glyph_cap - 1;
+    uint32_t j    = cp_hash(cp) & mask;
+    while (fe->glyphs[j].cp) j = (j + 1) & mask;
+
+    ENG_Glyph* g = &fe->glyphs[j];
+    fe->glyph_count++;
+    const ENG_FontCacheGlyph* d = fe->disk && fe->disk->count ? eng_fontcache_find(fe, cp) : NULL;
+    if (d) {  /* ディスクキャッシュの寸法 (SDF の枠も含む) */
+        *g = (ENG_Glyph){ cp, 0, d->advance, d->xoff, d->yoff, d->w, d->h, 0, 0, 0, 0 };
+        return g;
+    }
+
+    const stbtt_fontinfo* info = (const stbtt_fontinfo*)fe->info;
+    int adv, lsb, x0, y0, x1, y1;
+    stbtt_GetCodepointHMetrics(info, (int)cp, &adv, &lsb);
+    stbtt_GetCodepointBitmapBox(info, (int)cp, fe->scale, fe->scale, &x0, &y0, &x1, &y1);
+    memset(g, 0, sizeof(*g));
+    g->cp      = cp;
+    g->advance = (float)adv * fe->scale;
+    g->xoff    = (int16_t)x0;
+    g->yoff    = (int16_t)y0;
+    g->w       = (uint16_t)(x1 > x0 ? x1 - x0 : 0);
+    g->h       = (uint16_t)(y1 > y0 ? y1 - y0 : 0);
+    if (fe->sdf && g->w && g->h) {  /* stbtt_GetCodepointSDF と同じ枠 (輪郭の外側に PAD) */
+        g->xoff = (int16_t)(g->xoff - ENG_SDF_PAD);
+        g->yoff = (int16_t)(g->yoff - ENG_SDF_PAD);
+        g->w    = (uint16_t)(g->w + 2 * ENG_SDF_PAD);
+        g->h    = (uint16_t)(g->h + 2 * ENG_SDF_PAD);
+    }
+    return g;
+}
+
+/* g->w × g->h のビットマップを dst (行間隔 stride) へ描く。フォントデータは読むだけなので
+ * ワーカースレッドからも呼べる */
+bool eng_font_render_glyph(const void* info, float scale, bool sdf, const ENG_Glyph* g,
+                           unsigned char* dst, int stride) {
+    if (sdf) {
+        /* 輪郭 = 128、PAD px 離れると 0 / 255 */
+        int sw, sh, sx, sy;
+        unsigned char* d = stbtt_GetCodepointSDF((const stbtt_fontinfo*)info, scale,
+                                                 (int)g->cp, ENG_SDF_PAD, 128,
+                                                 128.0f / ENG_SDF_PAD, &sw, &sh, &sx, &sy);
+        if (!d) return false;
+        int cw = sw < g->w ? sw : g->w;
+        int ch = sh < g->h ? sh : g->h;
+        for (int row = 0; row < g->h; ++row) memset(dst + (size_t)row * (size_t)stride, 0, g->w);
+        for (int row = 0; row < ch; ++row) {
+            memcpy(dst + (size_t)row * (size_t)stride, d + (size_t)row * (size_t)sw, (size_t)cw);
         }
-        stbtt_bakedchar* b = &baked[c - 32];
-        float qx = cx2 + b->xoff;
-        float qy = cy2 + b->yoff;
-        float qw = (float)(b->x1 - b->x0);
-        float qh = (float)(b->y1 - b->y0);
-        float u0 = b->x0 / aw, v0 = b->y0 / ah;
-        float u1 = b->x1 / aw, v1 = b->y1 / ah;
+        stbtt_FreeSDF(d, NULL);
+    } else {
+        stbtt_MakeCodepointBitmap((const stbtt_fontinfo*)info, dst,
+                                  g->w, g->h, stride, scale, scale, (int)g->cp);
+    }
+    return true;
+}
+
+/* 画素 (行間隔 stride) をページへ複写して g をページ上に置く */
+static bool glyph_place(ENG_Renderer* r, ENG_Glyph* g, const unsigned char* src, int stride) {
+    int x, y;
+    int page = eng_glyph_alloc(r, g->w, g->h, &x, &y);
+    if (page < 0) return false;
+    ENG_GlyphPage* pg  = &r->glyphs.pages[page];
+    unsigned char* dst = pg->pixels + (size_t)y * ENG_GLYPH_PAGE_SIZE + x;
+    for (int row = 0; row < g->h; ++row) {
+        memcpy(dst + (size_t)row * ENG_GLYPH_PAGE_SIZE, src + (size_t)row * (size_t)stride, g->w);
+    }
+    g->page  = (uint8_t)(page + 1);
+    g->epoch = pg->epoch;
+    g->x     = (uint16_t)x;
+    g->y     = (uint16_t)y;
+    pg->last_used = r->tex_frame;
+    return true;
+}
+
+/* ── 非同期ラスタライズ (ワーカースレッド) ─────────────*/
+/* ジョブはフェイスの参照を 1 つ持つので、途中でフォントが解放されても info は有効 */
+typedef struct ENG_GlyphJob {
+    ENG_Renderer*  r;
+    ENG_FontID     font;
+    ENG_FaceID     face;
+    const void*    info;
+    float          scale;
+    bool           sdf;
+    ENG_Glyph      g;       /* cp, w, h のみ使う (表は伸長で動くので複製) */
+    unsigned char* pixels;  /* w × h */
+    bool           ok;
+} ENG_GlyphJob;
+
+static void glyph_job_free(ENG_GlyphJob* j) {
+    free(j->pixels);
+    face_release(j->r, j->face);
+    free(j);
+}
+
+static void glyph_job_run(void* arg) {
+    ENG_GlyphJob* j = (ENG_GlyphJob*)arg;
+    j->pixels = (unsigned char*)malloc((size_t)j->g.w * j->g.h);
+    j->ok     = j->pixels && eng_font_render_glyph(j->info, j->scale, j->sdf, &j->g,
+                                                   j->pixels, j->g.w);
+}
+
+/* 描画スレッド: 載せるのは eng_font_frame で予算内に */
+static void glyph_job_done(void* arg, bool cancelled) {
+    ENG_GlyphJob* j = (ENG_GlyphJob*)arg;
+    ENG_Renderer* r = j->r;
+    if (!cancelled && r->glyph_ready_count == r->glyph_ready_cap) {
+        int cap = r->glyph_ready_cap ? r->glyph_ready_cap * 2 : 64;
+        ENG_GlyphJob** q = (ENG_GlyphJob**)realloc(r->glyph_ready, (size_t)cap * sizeof(ENG_GlyphJob*));
+        if (q) { r->glyph_ready = q; r->glyph_ready_cap = cap; }
+    }
+    if (cancelled || r->glyph_ready_count == r->glyph_ready_cap) {
+        ENG_FontEntry* fe = font_get(r, j->font);
+        ENG_Glyph*     g  = fe ? glyph_lookup(fe, j->g.cp) : NULL;
+        if (g) g->pending = 0;  /* 次に描くとき頼み直す */
+        glyph_job_free(j);
+        return;
+    }
+    r->glyph_ready[r->glyph_ready_count++] = j;
+}
+
+static bool glyph_submit(ENG_Renderer* r, ENG_FontEntry* fe, ENG_Glyph* g) {
+    ENG_GlyphJob* j = (ENG_GlyphJob*)calloc(1, sizeof(ENG_GlyphJob));
+    if (!j) return false;
+    j->r     = r;
+    j->font  = fe->self;
+    j->face  = fe->face;
+    j->info  = fe->info;
+    j->scale = fe->scale;
+    j->sdf   = fe->sdf;
+    j->g     = *g;
+    if (!eng_jobs_submit(&r->jobs, glyph_job_run, glyph_job_done, j)) {
+        free(j);
+        return false;
+    }
+    face_get(r, fe->face)->refs++;
+    g->pending = 1;
+    return true;
+}
+
+/* 完成したグリフを先着順にページへ載せる (1 フレーム glyph_async 個まで)。
+ * 転送自体はページごとに次の eng_batch_flush でまとめて行われる */
+void eng_font_frame(ENG_Renderer* r) {
+    int n = r->glyph_ready_count;
+    if (r->glyph_async > 0 && n > r->glyph_async) n = r->glyph_async;
+    for (int i = 0; i < n; ++i) {
+        ENG_GlyphJob*  j  = r->glyph_ready[i];
+        ENG_FontEntry* fe = font_get(r, j->font);
+        ENG_Glyph*     g  = fe ? glyph_lookup(fe, j->g.cp) : NULL;
+        if (g && g->pending) {
+            g->pending = 0;
+            if (j->ok && g->w == j->g.w && g->h == j->g.h && glyph_place(r, g, j->pixels, g->w)) {
+                if (fe->face_hash) fe->disk_stale = true;
+                r->glyph_placed++;
+            }
+        }
+        glyph_job_free(j);
+    }
+    r->glyph_ready_count -= n;
+    memmove(r->glyph_ready, r->glyph_ready + n, (size_t)r->glyph_ready_count * sizeof(ENG_GlyphJob*));
+}
+
+void eng_set_async_glyphs(ENG_Renderer* r, int per_frame) {
+    if (!r) return;
+    r->glyph_async = per_frame > 0 ? per_frame : 0;
+    if (r->glyph_async == 0) eng_font_frame(r);  /* 同期に戻すなら待ちを全部載せる */
+}
+
+/* ページ上に画素があることを保証する。無ければディスクキャッシュから複写、それも無ければ
+ * ラスタライズ (非同期設定時はワーカーへ頼んで今回は描かない) */
+static bool glyph_raster(ENG_Renderer* r, ENG_FontEntry* fe, ENG_Glyph* g) {
+    ENG_GlyphCache* gc = &r->glyphs;
+    if (g->page && gc->pages[g->page - 1].epoch == g->epoch) {
+        gc->pages[g->page - 1].last_used = r->tex_frame;
+        return true;
+    }
+    const unsigned char* cached = fe->disk && fe->disk->count ? eng_fontcache_bitmap(fe, g) : NULL;
+    if (cached) return glyph_place(r, g, cached, g->w);
+
+    if (r->glyph_async > 0 && (g->pending || glyph_submit(r, fe, g))) {
+        r->glyph_misses++;
+        return false;
+    }
+    int x, y;
+    int page = eng_glyph_alloc(r, g->w, g->h, &x, &y);
+    if (page < 0) return false;
+    ENG_GlyphPage* pg = &gc->pages[page];
+    eng_font_render_glyph(fe->info, fe->scale, fe->sdf, g,
+                          pg->pixels + (size_t)y * ENG_GLYPH_PAGE_SIZE + x, ENG_GLYPH_PAGE_SIZE);
+    if (fe->face_hash) fe->disk_stale = true;
+    g->page  = (uint8_t)(page + 1);
+    g->epoch = pg->epoch;
+    g->x     = (uint16_t)x;
+    g->y     = (uint16_t)y;
+    pg->last_used = r->tex_frame;
+    return true;
+}
+
+/* 1 文字の送り幅 (グリフ単位。制御文字は従来どおり半角分の空白) */
+static float advance_of(ENG_FontEntry* fe, uint32_t cp) {
+    if (cp < 32) return eng_font_metric_size(fe) * 0.5f;
+    if (fe->baked) {
+        if (cp >= 128) return fe->size * 0.5f;
+        return ((stbtt_bakedchar*)fe->baked)[cp - 32].xadvance;
+    }
+    ENG_Glyph* g = glyph_find(fe, cp);
+    return g ? g->advance : 0.0f;
+}
+
+float eng_font_advance(ENG_FontEntry* fe, uint32_t cp, float k) {
+    return advance_of(fe, cp) * k;
+}
+
+/* 1 文字の矩形と UV を求める (必要ならラスタライズ)。(x, y) はベースライン上の原点、
+ * k はグリフ単位 → px の拡大率。描く画素が無ければ false */
+bool eng_font_quad(ENG_Renderer* r, ENG_FontEntry* fe, uint32_t cp,
+                   float x, float y, float k, ENG_GlyphQuad* q) {
+    if (cp < 32) return false;
+    if (fe->baked) {
+        if (cp >= 128) return false;
+        const stbtt_bakedchar* b = &((const stbtt_bakedchar*)fe->baked)[cp - 32];
+        if (b->x1 <= b->x0 || b->y1 <= b->y0) return false;
+        float aw = (float)fe->atlas_w;
+        float ah = (float)fe->atlas_h;
+        q->x = x + b->xoff * k;
+        q->y = y + b->yoff * k;
+        q->w = (float)(b->x1 - b->x0) * k;
+        q->h = (float)(b->y1 - b->y0) * k;
+        q->u0 = b->x0 / aw; q->v0 = b->y0 / ah; q->u1 = b->x1 / aw; q->v1 = b->y1 / ah;
+        q->tex  = fe->atlas_tex;
+        q->mode = ENG_DRAW_TEX;
+        q->page = -1;
+        return true;
+    }
+
+    ENG_Glyph* g = glyph_find(fe, cp);
+    if (!g || g->w == 0 || g->h == 0 || !glyph_raster(r, fe, g)) return false;
+    const float inv = 1.0f / (float)ENG_GLYPH_PAGE_SIZE;
+    q->x = x + g->xoff * k;
+    q->y = y + g->yoff * k;
+    q->w = (float)g->w * k;
+    q->h = (float)g->h * k;
+    q->u0 = g->x * inv; q->v0 = g->y * inv;
+    q->u1 = (g->x + g->w) * inv; q->v1 = (g->y + g->h) * inv;
+    q->page = g->page - 1;
+    q->tex  = r->glyphs.pages[q->page].tex;
+    q->mode = fe->sdf ? ENG_DRAW_SDF : ENG_DRAW_TEX;
+    return true;
+}
+
+/* 1 文字をバッチへ送り、送り幅 (px) を返す。回転時は文字列の原点 (px, py) まわりに回す */
+static float draw_glyph(ENG_Renderer* r, ENG_FontEntry* fe, uint32_t cp, float x, float y,
+                        float k, float rot, float px, float py,
+                        float cr, float cg, float cb, float ca) {
+    ENG_GlyphQuad q;
+    if (eng_font_quad(r, fe, cp, x, y, k, &q)) {
+        ENG_TexRef ref = { q.tex, 0, 0.0f, 0.0f, 1.0f, 1.0f, q.mode, 0 };
+        /* ox, oy はクワッド内の割合 */
+        float ox = rot != 0.0f ? (px - q.x) / q.w : 0.0f;
+        float oy = rot != 0.0f ? (py - q.y) / q.h : 0.0f;
         eng_batch_push_quad(r,
-            qx, qy, qw, qh,
-            u0, v0, u1, v1,
-            0.0f, 0.0f, 0.0f,
+            q.x, q.y, q.w, q.h,
+            q.u0, q.v0, q.u1, q.v1,
+            rot, ox, oy,
             cr, cg, cb, ca,
-            gl_id, true
+            &ref
         );
-        cx2 += b->xadvance;
+    }
+    return advance_of(fe, cp) * k;
+}
+
+/* ── テキスト描画 ───────────────────────────────────────*/
+void eng_draw_text_ex(ENG_Renderer* r, ENG_FontID fid, const char* text,
+                      float x, float y, float size, float rot,
+                      float cr, float cg, float cb, float ca) {
+    ENG_FontEntry* fe = font_get(r, fid);
+    if (!fe || !text) return;
+    if (size <= 0.0f) size = fe->size;
+
+    /* 回転前の位置に並べ、クワッドごとに原点まわりで回す */
+    float k   = size / eng_font_metric_size(fe);
+    float cx2 = x;
+    for (const char* p = text; *p; ) {
+        uint32_t cp = eng_utf8_next(&p);
+        cx2 += draw_glyph(r, fe, cp, cx2, y, k, rot, x, y, cr, cg, cb, ca);
     }
 }
 
+void eng_draw_text(ENG_Renderer* r, ENG_FontID fid,
+                   const char* text,
+                   float x, float y,
+                   float cr, float cg, float cb, float ca) {
+    eng_draw_text_ex(r, fid, text, x, y, 0.0f, 0.0f, cr, cg, cb, ca);
+}
+
 /* ── テキスト幅計算 ─────────────────────────────────────*/
 float eng_text_width(ENG_Renderer* r, ENG_FontID fid, const char* text) {
-    if (!r || fid == 0 || !text) return 0.0f;
-    int slot = (int)fid - 1;
-    if (slot < 0 || slot >= ENG_MAX_FONTS || !r->fonts[slot].used) return 0.0f;
-    stbtt_bakedchar* baked = (stbtt_bakedchar*)r->fonts[slot].baked;
+    ENG_FontEntry* fe = font_get(r, fid);
+    if (!fe || !text) return 0.0f;
     float w = 0.0f;
-    for (const char* p = text; *p; ++p) {
-        unsigned char c = (unsigned char)*p;
-        if (c < 32 || c >= 128) { w += r->fonts[slot].size * 0.5f; continue; }
-        w += baked[c - 32].xadvance;
-    }
-    return w;
+    for (const char* p = text; *p; ) w += advance_of(fe, eng_utf8_next(&p));
+    return w * eng_font_k(fe);
 }
 
 /* ── テキスト行高さ ─────────────────────────────────────*/
 float eng_text_height(ENG_Renderer* r, ENG_FontID fid) {
-    if (!r || fid == 0) return 0.0f;
-    int slot = (int)fid - 1;
-    if (slot < 0 || slot >= ENG_MAX_FONTS || !r->fonts[slot].used) return 0.0f;
-    return r->fonts[slot].size;
-}
-
-/* ── テキスト折り返し描画 ───────────────────────────────*/
-void eng_draw_text_wrap(ENG_Renderer* r, ENG_FontID fid,
-                         const char* text,
-                         float x, float y, float max_w,
-                         float cr, float cg, float cb, float ca) {
-    if (!r || !text || fid == 0 || max_w <= 0.0f) return;
-    int slot = (int)fid - 1;
-    if (slot < 0 || slot >= ENG_MAX_FONTS || !r->fonts[slot].used) return;
-    float line_h = r->fonts[slot].size * 1.2f;  /* 行間 = フォントサイズ * 1.2 */
-    /* 単語ごとに折り返す (スペースで分割; 日本語は文字ごと) */
-    static char line_buf[1024];
-    float cx2  = x;
-    float cy2  = y;
-    const char* p = text;
-    while (*p) {
-        /* 1文字分の幅を計算 */
-        unsigned char c = (unsigned char)*p;
-        float advance = 0.0f;
-        if (c == '\n') {
-            /* 改行 */
-            cx2 = x; cy2 += line_h; p++; continue;
-        }
-        if (c < 32 || c >= 128) {
-            /* 非ASCII: フォントサイズを近似幅として使用 */
-            advance = r->fonts[slot].size;
-        } else {
-            stbtt_bakedchar* baked = (stbtt_bakedchar*)r->fonts[slot].baked;
-            advance = baked[c - 32].xadvance;
-        }
-        if (cx2 + advance > x + max_w && cx2 > x) {
-            /* 折り返し */
-            cx2 = x; cy2 += line_h;
-        }
-        /* 1文字を描画 (eng_draw_text を文字ごと呼ぶのはコスト大なので
-         * 直接バッチに1文字送る) */
-        line_buf[0] = (char)c; line_buf[1] = '\0';
-        eng_draw_text(r, fid, line_buf, cx2, cy2, cr, cg, cb, ca);
-        cx2 += advance;
-        p++;
-    }
+    const ENG_FontEntry* fe = font_get(r, fid);
+    return fe ? fe->size : 0.0f;
 }
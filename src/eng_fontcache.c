@@ -0,0 +1,247 @@
+/**
+ * src/eng_fontcache.c — ラスタライズ済みグリフのディスクキャッシュ (.hjgc)
+ *
+ * eng_set_font_cache_dir で有効にすると、TTF フォントはフェイス内容のハッシュ・
+ * サイズ・種別 (通常 / SDF) ごとのファイルを mmap で開き、載っている文字は
+ * stb_truetype を通さずに寸法と画素を複写するだけで済ませる (SDF では特に効く)。
+ * 同じファイルを使うフォント (SDF はサイズ違いも同じ) は開いたマッピングを共有し、
+ * キャッシュに無い文字をラスタライズしたフォントは解放時にその分を共有の内容へ足す。
+ * 最後のフォントが解放されたら「前回の分 + 今回使った分」で書き直す。
+ * 一時ファイルに書いてから置き換えるので、途中で落ちても壊れたキャッシュは残らない。
+ * 検証に失敗したファイルは無視して作り直す。
+ */
+#include "eng_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <direct.h>
+  #define eng_mkdir(p) _mkdir(p)
+#else
+  #include <sys/stat.h>
+  #define eng_mkdir(p) mkdir((p), 0755)
+#endif
+
+/* ── ハッシュ (8 byte 単位, フェイス 1 つにつき 1 回) ──*/
+uint64_t eng_fontcache_hash(const unsigned char* p, size_t n) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ (uint64_t)n;
+    size_t   i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t v;
+        memcpy(&v, p + i, 8);
+        h = (h ^ v) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < n; ++i) h = (h ^ p[i]) * 0x100000001B3ull;
+    h ^= h >> 29;
+    return h ? h : 1;
+}
+
+static void cache_path(const ENG_Renderer* r, const ENG_FontEntry* fe, char* dst, size_t cap) {
+    snprintf(dst, cap, "%s/%016llx-%d%s.hjgc", r->font_cache_dir,
+             (unsigned long long)fe->face_hash, (int)(eng_font_metric_size(fe) * 64.0f + 0.5f),
+             fe->sdf ? "-sdf" : "");
+}
+
+/* ── 設定 ───────────────────────────────────────────────*/
+void eng_set_font_cache_dir(ENG_Renderer* r, const char* dir) {
+    if (!r) return;
+    free(r->font_cache_dir);
+    r->font_cache_dir = NULL;
+    if (!dir || !*dir) return;
+    size_t len = strlen(dir);
+    while (len > 1 && (dir[len - 1] == '/' || dir[len - 1] == '\\')) len--;
+    r->font_cache_dir = (char*)malloc(len + 1);
+    if (!r->font_cache_dir) return;
+    memcpy(r->font_cache_dir, dir, len);
+    r->font_cache_dir[len] = '\0';
+    eng_mkdir(r->font_cache_dir);  /* 既にあれば失敗するが構わない */
+}
+
+/* ── 読込 ───────────────────────────────────────────────*/
+static bool validate(const ENG_FontEntry* fe, const ENG_FileMap* m) {
+    if (m->size < sizeof(ENG_FontCacheHeader)) return false;
+    const ENG_FontCacheHeader* h = (const ENG_FontCacheHeader*)m->data;
+    if (h->magic != ENG_FONTCACHE_MAGIC || h->version != ENG_FONTCACHE_VERSION) return false;
+    if (h->face_hash != fe->face_hash || h->size != eng_font_metric_size(fe) ||
+        h->sdf != (uint32_t)fe->sdf) return false;
+    uint64_t need = sizeof(ENG_FontCacheHeader) +
+                    (uint64_t)h->glyph_count * sizeof(ENG_FontCacheGlyph) + h->pixel_size;
+    if (need != m->size) return false;
+
+    const ENG_FontCacheGlyph* g = (const ENG_FontCacheGlyph*)(h + 1);
+    for (uint32_t i = 0; i < h->glyph_count; ++i) {
+        if (i > 0 && g[i].cp <= g[i - 1].cp) return false;
+        if ((uint64_t)g[i].offset + (uint64_t)g[i].w * g[i].h > h->pixel_size) return false;
+    }
+    return true;
+}
+
+/* 同じキーのフォントが開いているキャッシュ */
+static ENG_FontDisk* disk_shared(ENG_Renderer* r, const ENG_FontEntry* fe) {
+    for (int i = 0; i < r->fonts.cap; ++i) {
+        const ENG_FontEntry* o = eng_font_get(r, eng_slots_id_at(&r->fonts, i));
+        if (o && o != fe && o->disk && o->face_hash == fe->face_hash && o->sdf == fe->sdf &&
+            eng_font_metric_size(o) == eng_font_metric_size(fe)) return o->disk;
+    }
+    return NULL;
+}
+
+/* data は検証済みのファイル内容 */
+static void disk_view(ENG_FontDisk* dc, const unsigned char* data) {
+    const ENG_FontCacheHeader* h = (const ENG_FontCacheHeader*)data;
+    dc->glyphs   = (const ENG_FontCacheGlyph*)(h + 1);
+    dc->count    = h->glyph_count;
+    dc->pix      = (const unsigned char*)(dc->glyphs + h->glyph_count);
+    dc->pix_size = h->pixel_size;
+}
+
+void eng_fontcache_open(ENG_Renderer* r, ENG_FontEntry* fe) {
+    if (!r->font_cache_dir || !fe->face_hash) return;
+    ENG_FontDisk* dc = disk_shared(r, fe);
+    if (dc) {
+        dc->refs++;
+        fe->disk = dc;
+        return;
+    }
+    dc = (ENG_FontDisk*)calloc(1, sizeof(ENG_FontDisk));
+    if (!dc) return;
+    dc->refs = 1;
+    fe->disk = dc;
+
+    char path[1024];
+    cache_path(r, fe, path, sizeof(path));
+    if (!eng_file_map(path, &dc->map)) return;  /* まだ無い */
+    if (!validate(fe, &dc->map)) {
+        fprintf(stderr, "[eng_render] グリフキャッシュを作り直します: %s\n", path);
+        eng_file_unmap(&dc->map);
+        fe->disk_stale = true;
+        return;
+    }
+    disk_view(dc, dc->map.data);
+}
+
+const ENG_FontCacheGlyph* eng_fontcache_find(const ENG_FontEntry* fe, uint32_t cp) {
+    const ENG_FontDisk* dc = fe->disk;
+    uint32_t lo = 0, hi = dc->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        uint32_t c   = dc->glyphs[mid].cp;
+        if (c == cp) return &dc->glyphs[mid];
+        if (c < cp) lo = mid + 1; else hi = mid;
+    }
+    return NULL;
+}
+
+const unsigned char* eng_fontcache_bitmap(const ENG_FontEntry* fe, const ENG_Glyph* g) {
+    const ENG_FontCacheGlyph* d = fe->disk && fe->disk->count ? eng_fontcache_find(fe, g->cp) : NULL;
+    if (!d || d->w != g->w || d->h != g->h) return NULL;
+    return fe->disk->pix + d->offset;
+}
+
+/* ── 保存 ───────────────────────────────────────────────*/
+static int cmp_cp(const void* a, const void* b) {
+    uint32_t x = ((const ENG_FontCacheGlyph*)a)->cp, y = ((const ENG_FontCacheGlyph*)b)->cp;
+    return x < y ? -1 : x > y;
+}
+
+/* 前回の分 + グリフ表の分を 1 つのバッファに組み立てる (画素はページの複製か再ラスタライズ) */
+static unsigned char* build_file(ENG_Renderer* r, const ENG_FontEntry* fe, size_t* out_size) {
+    const ENG_FontDisk* dc = fe->disk;
+    uint32_t max_count = dc->count + (uint32_t)fe->glyph_count;
+    uint64_t pix_size  = dc->count ? dc->pix_size : 0;
+    for (int i = 0; i < fe->glyph_cap; ++i) {
+        const ENG_Glyph* g = &fe->glyphs[i];
+        if (g->cp) pix_size += (uint64_t)g->w * g->h;
+    }
+    if (pix_size > UINT32_MAX) return NULL;
+
+    size_t head = sizeof(ENG_FontCacheHeader) + (size_t)max_count * sizeof(ENG_FontCacheGlyph);
+    unsigned char* buf = (unsigned char*)malloc(head + (size_t)pix_size);
+    if (!buf) return NULL;
+    ENG_FontCacheGlyph* out = (ENG_FontCacheGlyph*)(buf + sizeof(ENG_FontCacheHeader));
+    unsigned char*      pix = buf + head;  /* 件数確定後に詰め直す */
+    uint32_t n = 0, off = 0;
+
+    for (uint32_t i = 0; i < dc->count; ++i) {
+        const ENG_FontCacheGlyph* d = &dc->glyphs[i];
+        size_t sz = (size_t)d->w * d->h;
+        out[n] = *d;
+        out[n++].offset = off;
+        memcpy(pix + off, dc->pix + d->offset, sz);
+        off += (uint32_t)sz;
+    }
+    for (int i = 0; i < fe->glyph_cap; ++i) {
+        const ENG_Glyph* g = &fe->glyphs[i];
+        if (!g->cp || (dc->count && eng_fontcache_find(fe, g->cp))) continue;
+        size_t sz = (size_t)g->w * g->h;
+        if (sz) {
+            const ENG_GlyphPage* pg = g->page ? &r->glyphs.pages[g->page - 1] : NULL;
+            if (pg && pg->epoch == g->epoch) {
+                const unsigned char* src = pg->pixels + (size_t)g->y * ENG_GLYPH_PAGE_SIZE + g->x;
+                for (int row = 0; row < g->h; ++row) {
+                    memcpy(pix + off + (size_t)row * g->w, src + (size_t)row * ENG_GLYPH_PAGE_SIZE, g->w);
+                }
+            } else if (!eng_font_render_glyph(fe->info, fe->scale, fe->sdf, g, pix + off, g->w)) {
+                continue;
+            }
+        }
+        out[n++] = (ENG_FontCacheGlyph){ g->cp, g->advance, g->xoff, g->yoff, g->w, g->h, off };
+        off += (uint32_t)sz;
+    }
+    qsort(out, n, sizeof(ENG_FontCacheGlyph), cmp_cp);
+
+    /* 記録が減った分だけ画素を前に詰める */
+    size_t real_head = sizeof(ENG_FontCacheHeader) + (size_t)n * sizeof(ENG_FontCacheGlyph);
+    memmove(buf + real_head, pix, off);
+    ENG_FontCacheHeader h = {
+        ENG_FONTCACHE_MAGIC, ENG_FONTCACHE_VERSION, fe->face_hash,
+        eng_font_metric_size(fe), (uint32_t)fe->sdf, n, off
+    };
+    memcpy(buf, &h, sizeof(h));
+    *out_size = real_head + off;
+    return buf;
+}
+
+void eng_fontcache_close(ENG_Renderer* r, ENG_FontEntry* fe) {
+    ENG_FontDisk* dc = fe->disk;
+    if (!dc) return;
+    /* このフォントの分を共有の内容へ足す (他のフォントもすぐ使える) */
+    if (fe->disk_stale && r->font_cache_dir) {
+        size_t         size = 0;
+        unsigned char* buf  = build_file(r, fe, &size);
+        if (buf) {
+            free(dc->merged);
+            dc->merged      = buf;
+            dc->merged_size = size;
+            disk_view(dc, buf);
+        }
+    }
+    fe->disk       = NULL;
+    fe->disk_stale = false;
+    if (--dc->refs > 0) return;  /* 書き出しは最後のフォントが閉じるとき */
+
+    unsigned char* buf  = dc->merged;
+    size_t         size = dc->merged_size;
+    /* 置き換える前に閉じる (Windows はマップ中のファイルを上書きできない) */
+    eng_file_unmap(&dc->map);
+    free(dc);
+    if (!buf || !r->font_cache_dir) { free(buf); return; }
+
+    char path[1024], tmp[1040];
+    cache_path(r, fe, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE* f  = fopen(tmp, "wb");
+    bool  ok = f && fwrite(buf, 1, size, f) == size;
+    if (f && fclose(f) != 0) ok = false;
+    free(buf);
+    if (ok) {
+        remove(path);
+        ok = rename(tmp, path) == 0;
+    }
+    if (!ok) {
+        remove(tmp);
+        fprintf(stderr, "[eng_render] グリフキャッシュを書き込めません: %s\n", path);
+    }
+}
@@ -0,0 +1,174 @@
+/**
+ * src/eng_frame.c — フレームペーシングとフレーム時間の統計
+ *
+ * FPS 上限は「次のフレームを始める時刻」を周期ずつ進めて待つ (待ち時間の切り捨てが溜まらない)。
+ * ハイブリッドでは締切の少し手前まで SDL_Delay で寝て、残りを高精度カウンタでスピンする。
+ * スピンの長さは SDL_Delay の寝過ごし量から自動で決める (OS のタイマー精度に合わせる)。
+ *
+ * フレーム時間はスワップ間隔 (実際に画面へ出た間隔) を ENG_FRAME_HISTORY フレーム分だけ覚え、
+ * eng_frame_stats で p50/p95/p99 とヒッチ数を返す。FPS も同じ窓の平均から求める。
+ *
+ * 固定ステップは実時間を貯めて dt ごとに取り出し、このフレームで回す回数と
+ * 余りの割合 (描画の補間係数) を決める。回数には上限を設け、重いフレームが
+ * 次のフレームをさらに重くする連鎖を断つ (上限を超えた分の時間は捨てる)。
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define spin_pause() _mm_pause()
+#else
+  #define spin_pause() ((void)0)
+#endif
+
+#define SPIN_MIN_MS   0.25
+#define SPIN_MAX_MS   4.0
+#define HITCH_FACTOR  1.5  /* 目標の何倍を超えたらヒッチとみなすか */
+
+/* ── 設定 ───────────────────────────────────────────────*/
+void eng_set_pacing(ENG_Renderer* r, ENG_Pacing mode) {
+    if (!r || mode < ENG_PACE_SLEEP || mode > ENG_PACE_SPIN) return;
+    r->pacing = mode;
+}
+
+bool eng_set_vsync(ENG_Renderer* r, ENG_VSync mode) {
+    if (!r) return false;
+    if (SDL_GL_SetSwapInterval((int)mode) == 0) {
+        r->vsync = mode;
+        return true;
+    }
+    /* 適応 (遅れたフレームだけ待たずに出す) に非対応なら通常の VSync にする */
+    if (mode == ENG_VSYNC_ADAPTIVE && SDL_GL_SetSwapInterval(1) == 0) r->vsync = ENG_VSYNC_ON;
+    return false;
+}
+
+/* ── 待機 ───────────────────────────────────────────────*/
+static void wait_until(ENG_Renderer* r, uint64_t deadline, uint64_t freq) {
+    uint64_t now = SDL_GetPerformanceCounter();
+    if (now >= deadline) return;
+
+    if (r->pacing != ENG_PACE_SPIN) {
+        double remain = (double)(deadline - now) * 1000.0 / (double)freq;
+        double sleep  = r->pacing == ENG_PACE_HYBRID ? remain - r->pace_spin_ms : remain;
+        if (sleep >= 1.0) {
+            uint32_t ms = (uint32_t)sleep;
+            SDL_Delay(ms);
+            uint64_t woke = SDL_GetPerformanceCounter();
+            if (r->pacing == ENG_PACE_HYBRID) {
+                /* 寝過ごした分 + 余裕。増えるときはすぐ、減るときはゆっくり追う */
+                double over = (double)(woke - now) * 1000.0 / (double)freq - (double)ms;
+                double want = over + SPIN_MIN_MS;
+                double spin = want > r->pace_spin_ms ? want : r->pace_spin_ms * 0.98 + want * 0.02;
+                r->pace_spin_ms = spin < SPIN_MIN_MS ? SPIN_MIN_MS : spin > SPIN_MAX_MS ? SPIN_MAX_MS : spin;
+            }
+        }
+        if (r->pacing == ENG_PACE_SLEEP) return;
+    }
+    while (SDL_GetPerformanceCounter() < deadline) spin_pause();
+}
+
+void eng_frame_pace(ENG_Renderer* r) {
+    if (r->fps_cap <= 0) {
+        r->pace_deadline = 0;
+        return;
+    }
+    uint64_t freq   = SDL_GetPerformanceFrequency();
+    uint64_t period = freq / (uint64_t)r->fps_cap;
+    uint64_t now    = SDL_GetPerformanceCounter();
+    /* 1 周期以上遅れたら基準を取り直す (遅れをまとめて取り返そうとしない) */
+    if (r->pace_deadline == 0 || now > r->pace_deadline + period) {
+        r->pace_deadline = now;
+    } else {
+        wait_until(r, r->pace_deadline, freq);
+    }
+    r->pace_deadline += period;
+}
+
+/* ── 記録 ───────────────────────────────────────────────*/
+void eng_frame_swapped(ENG_Renderer* r) {
+    uint64_t now  = SDL_GetPerformanceCounter();
+    uint64_t prev = r->last_swap_tick;
+    r->last_swap_tick = now;
+    if (prev == 0) return;
+
+    float ms = (float)((double)(now - prev) * 1000.0 / (double)SDL_GetPerformanceFrequency());
+    /* ヒッチの基準: 上限があればその周期、無ければ窓の平均 */
+    double expect = r->fps_cap > 0 ? 1000.0 / r->fps_cap
+                  : r->frame_count > 0 ? r->frame_sum_ms / r->frame_count : (double)ms;
+    uint8_t hitch = (double)ms > expect * HITCH_FACTOR;
+
+    int i = r->frame_head;
+    if (r->frame_count == ENG_FRAME_HISTORY) {  /* 一番古い分を窓から外す */
+        r->frame_sum_ms  -= r->frame_ms[i];
+        r->frame_hitches -= r->frame_hitch[i];
+    } else {
+        r->frame_count++;
+    }
+    r->frame_ms[i]    = ms;
+    r->frame_hitch[i] = hitch;
+    r->frame_sum_ms  += ms;
+    r->frame_hitches += hitch;
+    r->hitch_total   += hitch;
+    r->frame_head = (i + 1) % ENG_FRAME_HISTORY;
+    if (r->frame_sum_ms > 0.0) r->fps = r->frame_count * 1000.0 / r->frame_sum_ms;
+}
+
+/* ── 固定ステップ ───────────────────────────────────────*/
+void eng_set_fixed_step(ENG_Renderer* r, double hz, int max_steps) {
+    if (!r) return;
+    r->fixed_dt        = hz > 0.0 ? 1.0 / hz : 0.0;
+    r->fixed_max_steps = max_steps > 0 ? max_steps : 5;
+    r->fixed_acc       = 0.0;
+    r->fixed_steps     = 0;
+    r->fixed_alpha     = 0.0;
+}
+
+void eng_frame_fixed(ENG_Renderer* r, double dt) {
+    if (r->fixed_dt <= 0.0) return;
+    double limit = r->fixed_dt * r->fixed_max_steps;
+    r->fixed_acc += dt > 0.0 ? dt : 0.0;
+    if (r->fixed_acc > limit) r->fixed_acc = limit;  /* 追いつけない分は捨てる */
+    int n = (int)(r->fixed_acc / r->fixed_dt);
+    r->fixed_acc  -= n * r->fixed_dt;
+    r->fixed_steps = n;
+    r->fixed_alpha = r->fixed_acc / r->fixed_dt;
+}
+
+int    eng_fixed_steps(ENG_Renderer* r) { return r ? r->fixed_steps : 0; }
+double eng_fixed_dt(ENG_Renderer* r)    { return r ? r->fixed_dt    : 0.0; }
+double eng_fixed_alpha(ENG_Renderer* r) { return r ? r->fixed_alpha : 0.0; }
+
+/* ── 統計 ───────────────────────────────────────────────*/
+static int cmp_float(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return x < y ? -1 : x > y;
+}
+
+/* 最近順位法 (値の並びから ceil(p·n) 番目) */
+static double percentile(const float* sorted, int n, double p) {
+    int k = (int)(p * n + 0.999999);
+    if (k < 1) k = 1;
+    return sorted[k - 1];
+}
+
+void eng_frame_stats(ENG_Renderer* r, ENG_FrameStats* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!r) return;
+    out->hitch_total = r->hitch_total;
+    int n = r->frame_count;
+    if (n == 0) return;
+
+    float sorted[ENG_FRAME_HISTORY];
+    memcpy(sorted, r->frame_ms, (size_t)n * sizeof(float));  /* 窓が埋まるまでは先頭から n 件 */
+    qsort(sorted, (size_t)n, sizeof(float), cmp_float);
+    out->frames  = n;
+    out->hitches = r->frame_hitches;
+    out->avg_ms  = r->frame_sum_ms / n;
+    out->p50_ms  = percentile(sorted, n, 0.50);
+    out->p95_ms  = percentile(sorted, n, 0.95);
+    out->p99_ms  = percentile(sorted, n, 0.99);
+    out->max_ms  = sorted[n - 1];
+}
@@ -0,0 +1,166 @@
+/**
+ * src/eng_glyph.c — グリフキャッシュのページ管理 (棚詰め + ページ単位 LRU)
+ *
+ * 全フォントのグリフを ENG_GLYPH_PAGE_SIZE² の R8 ページに棚 (shelf) 方式で詰める。
+ * 同じ高さ帯のグリフが並ぶので、CJK のように寸法の揃った文字が多くても無駄が少ない。
+ * ページが尽きたら最も長く描かれていないページを丸ごと空け、
+ * 載っていたグリフは epoch 不一致で次に使うときラスタライズし直す。
+ *
+ * ラスタライズ結果は CPU 側の複製に書くだけで、GL への転送は
+ * eng_batch_flush 直前にページごと 1 回の glTexSubImage2D (変更行の範囲) で行う。
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* ── 棚詰め ─────────────────────────────────────────────*/
+/* 高さが近い棚に右詰めで置く。合う棚が無ければ下に新しい棚を作る */
+static bool shelf_insert(ENG_GlyphPage* pg, int w, int h, int* out_x, int* out_y) {
+    int best = -1, best_waste = ENG_GLYPH_PAGE_SIZE;
+    for (int i = 0; i < pg->shelf_count; ++i) {
+        const ENG_GlyphShelf* sh = &pg->shelves[i];
+        if (sh->h < h || sh->x + w > ENG_GLYPH_PAGE_SIZE) continue;
+        if (sh->h - h < best_waste) { best = i; best_waste = sh->h - h; }
+    }
+
+    int top = 0;
+    if (pg->shelf_count > 0) {
+        const ENG_GlyphShelf* last = &pg->shelves[pg->shelf_count - 1];
+        top = last->y + last->h;
+    }
+    /* 高すぎる棚に低いグリフを置くのは、新しい棚を作れないときだけ */
+    bool can_open = top + h <= ENG_GLYPH_PAGE_SIZE;
+    if (best >= 0 && (best_waste <= h / 2 || !can_open)) {
+        ENG_GlyphShelf* sh = &pg->shelves[best];
+        *out_x = sh->x;
+        *out_y = sh->y;
+        sh->x += w;
+        return true;
+    }
+    if (!can_open) return false;
+
+    if (pg->shelf_count + 1 > pg->shelf_cap) {
+        int cap = pg->shelf_cap ? pg->shelf_cap * 2 : 32;
+        ENG_GlyphShelf* n = (ENG_GlyphShelf*)realloc(pg->shelves, (size_t)cap * sizeof(ENG_GlyphShelf));
+        if (!n) return false;
+        pg->shelves = n; pg->shelf_cap = cap;
+    }
+    pg->shelves[pg->shelf_count++] = (ENG_GlyphShelf){ top, h, w };
+    *out_x = 0;
+    *out_y = top;
+    return true;
+}
+
+/* ── ページ ─────────────────────────────────────────────*/
+static bool page_create(ENG_GlyphPage* pg) {
+    pg->pixels = (unsigned char*)calloc((size_t)ENG_GLYPH_PAGE_SIZE * ENG_GLYPH_PAGE_SIZE, 1);
+    if (!pg->pixels) return false;
+
+    glGenTextures(1, &pg->tex);
+    glBindTexture(GL_TEXTURE_2D, pg->tex);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ENG_GLYPH_PAGE_SIZE, ENG_GLYPH_PAGE_SIZE,
+                 0, GL_RED, GL_UNSIGNED_BYTE, pg->pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    /* swizzle: R→RGBA (白テキスト) */
+    GLint swz[4] = {GL_RED, GL_RED, GL_RED, GL_RED};
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swz);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    pg->dirty_y0 = pg->dirty_y1 = 0;
+    return true;
+}
+
+/* 最も長く描かれていないページを空ける (そのページを待つクワッドは先に送る) */
+static int evict_lru(ENG_Renderer* r) {
+    ENG_GlyphCache* gc = &r->glyphs;
+    int victim = 0;
+    for (int i = 1; i < gc->page_count; ++i) {
+        if (gc->pages[i].last_used < gc->pages[victim].last_used) victim = i;
+    }
+    ENG_GlyphPage* pg = &gc->pages[victim];
+    if (r->batch.quad_count > 0 && r->batch.current_tex == pg->tex) eng_batch_flush(r);
+    eng_viewport_sync(r, pg->tex);
+    pg->shelf_count = 0;
+    pg->epoch++;
+    return victim;
+}
+
+/* ── 確保 ───────────────────────────────────────────────*/
+/* w×h (+ 右下に ENG_GLYPH_PAD) の領域を確保し、複製側をゼロで埋める */
+int eng_glyph_alloc(ENG_Renderer* r, int w, int h, int* x, int* y) {
+    ENG_GlyphCache* gc = &r->glyphs;
+    int pw = w + ENG_GLYPH_PAD, ph = h + ENG_GLYPH_PAD;
+    if (pw > ENG_GLYPH_PAGE_SIZE || ph > ENG_GLYPH_PAGE_SIZE) return -1;
+
+    int page = -1;
+    for (int i = 0; i < gc->page_count && page < 0; ++i) {
+        if (shelf_insert(&gc->pages[i], pw, ph, x, y)) page = i;
+    }
+    if (page < 0 && gc->page_count < ENG_GLYPH_MAX_PAGES &&
+        page_create(&gc->pages[gc->page_count])) {
+        page = gc->page_count++;
+        if (!shelf_insert(&gc->pages[page], pw, ph, x, y)) return -1;
+    }
+    if (page < 0) {
+        if (gc->page_count == 0) return -1;
+        page = evict_lru(r);
+        if (!shelf_insert(&gc->pages[page], pw, ph, x, y)) return -1;
+    }
+
+    /* 空けたページの古い画素が隙間に残らないよう、隙間ごと消す */
+    unsigned char* px = gc->pages[page].pixels + (size_t)*y * ENG_GLYPH_PAGE_SIZE + *x;
+    for (int row = 0; row < ph; ++row) memset(px + (size_t)row * ENG_GLYPH_PAGE_SIZE, 0, (size_t)pw);
+    eng_glyph_mark_dirty(r, page, *y, ph);
+    return page;
+}
+
+void eng_glyph_mark_dirty(ENG_Renderer* r, int page, int y, int h) {
+    ENG_GlyphPage* pg = &r->glyphs.pages[page];
+    if (pg->dirty_y0 >= pg->dirty_y1) {
+        pg->dirty_y0 = y;
+        pg->dirty_y1 = y + h;
+    } else {
+        if (y < pg->dirty_y0)     pg->dirty_y0 = y;
+        if (y + h > pg->dirty_y1) pg->dirty_y1 = y + h;
+    }
+    r->glyphs.dirty = true;
+}
+
+/* ── 転送 ───────────────────────────────────────────────*/
+/* 全幅の行範囲なので複製の連続領域をそのまま渡せる */
+void eng_glyph_upload(ENG_Renderer* r) {
+    ENG_GlyphCache* gc = &r->glyphs;
+    if (!gc->dirty) return;
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (int i = 0; i < gc->page_count; ++i) {
+        ENG_GlyphPage* pg = &gc->pages[i];
+        if (pg->dirty_y0 >= pg->dirty_y1) continue;
+        glBindTexture(GL_TEXTURE_2D, pg->tex);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, pg->dirty_y0,
+                        ENG_GLYPH_PAGE_SIZE, pg->dirty_y1 - pg->dirty_y0,
+                        GL_RED, GL_UNSIGNED_BYTE,
+                        pg->pixels + (size_t)pg->dirty_y0 * ENG_GLYPH_PAGE_SIZE);
+        pg->dirty_y0 = pg->dirty_y1 = 0;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    gc->dirty = false;
+    r->tex_upload_ticks += SDL_GetPerformanceCounter() - t0;
+}
+
+/* ── 終了処理 (eng_font_shutdown から) ─────────────────*/
+void eng_glyph_shutdown(ENG_Renderer* r) {
+    ENG_GlyphCache* gc = &r->glyphs;
+    for (int i = 0; i < gc->page_count; ++i) {
+        if (gc->pages[i].tex) glDeleteTextures(1, &gc->pages[i].tex);
+        free(gc->pages[i].pixels);
+        free(gc->pages[i].shelves);
+    }
+    memset(gc, 0, sizeof(*gc));
+}
@@ -0,0 +1,426 @@
+/**
+ * src/eng_image.c — 画像ファイルのデコード (GL 呼び出しなし)
+ *
+ * ワーカースレッドからも呼ばれるため GL には触れない。結果の ENG_Image を
+ * 描画スレッドで eng_texture.c が転送する。
+ *
+ *   PNG/JPG 等 — stb_image で RGBA8 にデコード (必要なら RGB565/RGBA4444 へ変換)
+ *   QOI / HJLZ — eng_codec.c の高速デコーダで RGBA8 に展開 (マジックで判別)
+ *   INDEX8 指定 — RGBA8 をパレット (出現順, 256 色まで) + 1 byte/px の番号に変換
+ *   DDS / KTX1 — BC1/BC3/BC7 をそのまま保持 (mmap 領域を直接転送)。
+ *                ドライバが非対応なら BC1/BC3 はソフトウェアで RGBA8 に展開
+ */
+#include "stb_image.h"
+
+#include "eng_internal.h"
+#include "eng_codec_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define ENG_PREMUL_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  #include <arm_neon.h>
+  #define ENG_PREMUL_NEON 1
+#endif
+
+/* ── リトルエンディアン読込 ─────────────────────────────*/
+static inline uint32_t rd32(const unsigned char* p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint16_t rd16(const unsigned char* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+/* ── 形式ごとのサイズ ───────────────────────────────────*/
+bool eng_texfmt_compressed(ENG_TexFormat f) {
+    return f == ENG_TEXFMT_BC1 || f == ENG_TEXFMT_BC3 || f == ENG_TEXFMT_BC7;
+}
+
+size_t eng_texfmt_level_size(ENG_TexFormat f, int w, int h) {
+    if (eng_texfmt_compressed(f)) {
+        size_t bw = (size_t)((w + 3) / 4), bh = (size_t)((h + 3) / 4);
+        if (bw == 0) bw = 1;
+        if (bh == 0) bh = 1;
+        return bw * bh * (f == ENG_TEXFMT_BC1 ? 8 : 16);
+    }
+    size_t bpp = (f == ENG_TEXFMT_RGBA8) ? 4 : (f == ENG_TEXFMT_INDEX8) ? 1 : 2;
+    return (size_t)w * (size_t)h * bpp;
+}
+
+/* ── DDS ────────────────────────────────────────────────*/
+#define DDS_HEADER_SIZE 128
+#define DX10_HEADER_SIZE 20
+#define FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+static bool parse_dds(const unsigned char* p, size_t n, ENG_Image* img, const char** err) {
+    if (n < DDS_HEADER_SIZE || rd32(p + 4) != 124) { *err = "DDS ヘッダーが不正"; return false; }
+    img->h      = (int)rd32(p + 12);
+    img->w      = (int)rd32(p + 16);
+    img->levels = (int)rd32(p + 28);
+    uint32_t fourcc = rd32(p + 84);
+    size_t   off    = DDS_HEADER_SIZE;
+
+    if (fourcc == FOURCC('D', 'X', 'T', '1'))      img->format = ENG_TEXFMT_BC1;
+    else if (fourcc == FOURCC('D', 'X', 'T', '5')) img->format = ENG_TEXFMT_BC3;
+    else if (fourcc == FOURCC('D', 'X', '1', '0')) {
+        if (n < DDS_HEADER_SIZE + DX10_HEADER_SIZE) { *err = "DDS DX10 ヘッダーが不正"; return false; }
+        switch (rd32(p + DDS_HEADER_SIZE)) {  /* DXGI_FORMAT */
+            case 71: case 72: img->format = ENG_TEXFMT_BC1; break;
+            case 77: case 78: img->format = ENG_TEXFMT_BC3; break;
+            case 98: case 99: img->format = ENG_TEXFMT_BC7; break;
+            default: *err = "未対応の DXGI 形式"; return false;
+        }
+        if (rd32(p + DDS_HEADER_SIZE + 12) > 1) { *err = "テクスチャ配列は未対応"; return false; }
+        off += DX10_HEADER_SIZE;
+    } else {
+        *err = "未対応の DDS 形式 (DXT1/DXT5/DX10 のみ)";
+        return false;
+    }
+
+    if (img->levels < 1) img->levels = 1;
+    if (img->levels > ENG_IMAGE_MAX_LEVELS) img->levels = ENG_IMAGE_MAX_LEVELS;
+    int w = img->w, h = img->h;
+    for (int i = 0; i < img->levels; ++i) {
+        size_t sz = eng_texfmt_level_size(img->format, w, h);
+        if (off + sz > n) {
+            if (i == 0) { *err = "DDS データが不足"; return false; }
+            img->levels = i;  /* 途中で切れていれば揃っている分だけ使う */
+            break;
+        }
+        img->level_off[i]  = off;
+        img->level_size[i] = sz;
+        off += sz;
+        if (w > 1) w /= 2;
+        if (h > 1) h /= 2;
+    }
+    return true;
+}
+
+/* ── KTX 1.1 ────────────────────────────────────────────*/
+static const unsigned char KTX_ID[12] = {
+    0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+#define KTX_HEADER_SIZE 64
+
+static bool parse_ktx(const unsigned char* p, size_t n, ENG_Image* img, const char** err) {
+    if (n < KTX_HEADER_SIZE) { *err = "KTX ヘッダーが不正"; return false; }
+    if (rd32(p + 12) != 0x04030201) { *err = "ビッグエンディアン KTX は未対応"; return false; }
+    switch (rd32(p + 28)) {  /* glInternalFormat */
+        case 0x83F0: case 0x83F1: img->format = ENG_TEXFMT_BC1; break;  /* DXT1 */
+        case 0x83F3:              img->format = ENG_TEXFMT_BC3; break;  /* DXT5 */
+        case 0x8E8C: case 0x8E8D: img->format = ENG_TEXFMT_BC7; break;  /* BPTC */
+        default: *err = "未対応の KTX 形式 (BC1/BC3/BC7 のみ)"; return false;
+    }
+    img->w      = (int)rd32(p + 36);
+    img->h      = (int)rd32(p + 40);
+    img->levels = (int)rd32(p + 56);
+    if (rd32(p + 44) > 1 || rd32(p + 48) > 1 || rd32(p + 52) != 1) {
+        *err = "2D 以外の KTX は未対応"; return false;
+    }
+    if (img->levels < 1) img->levels = 1;
+    if (img->levels > ENG_IMAGE_MAX_LEVELS) img->levels = ENG_IMAGE_MAX_LEVELS;
+
+    size_t off = KTX_HEADER_SIZE + (size_t)rd32(p + 60);
+    int    w   = img->w, h = img->h;
+    for (int i = 0; i < img->levels; ++i) {
+        /* 記録されたサイズが寸法に足りないレベルは使わない (展開時に読み過ぎる) */
+        size_t need = eng_texfmt_level_size(img->format, w, h);
+        size_t sz   = off + 4 <= n ? rd32(p + off) : 0;
+        if (off + 4 > n || sz < need || off + 4 + sz > n) {
+            if (i == 0) { *err = "KTX データが不足"; return false; }
+            img->levels = i;  /* 途中で切れていれば揃っている分だけ使う */
+            break;
+        }
+        off += 4;
+        img->level_off[i]  = off;
+        img->level_size[i] = need;
+        off += (sz + 3) & ~(size_t)3;
+        if (w > 1) w /= 2;
+        if (h > 1) h /= 2;
+    }
+    return true;
+}
+
+/* ── BC1 / BC3 ソフトウェア展開 ─────────────────────────*/
+static void bc_colors(const unsigned char* b, bool four_color, uint8_t out[4][4]) {
+    uint16_t c0 = rd16(b), c1 = rd16(b + 2);
+    for (int i = 0; i < 2; ++i) {
+        uint16_t c = i ? c1 : c0;
+        int r = (c >> 11) & 31, g = (c >> 5) & 63, bl = c & 31;
+        out[i][0] = (uint8_t)((r << 3) | (r >> 2));
+        out[i][1] = (uint8_t)((g << 2) | (g >> 4));
+        out[i][2] = (uint8_t)((bl << 3) | (bl >> 2));
+        out[i][3] = 255;
+    }
+    if (four_color || c0 > c1) {
+        for (int k = 0; k < 3; ++k) {
+            out[2][k] = (uint8_t)((2 * out[0][k] + out[1][k]) / 3);
+            out[3][k] = (uint8_t)((out[0][k] + 2 * out[1][k]) / 3);
+        }
+        out[2][3] = out[3][3] = 255;
+    } else {
+        for (int k = 0; k < 3; ++k) out[2][k] = (uint8_t)((out[0][k] + out[1][k]) / 2);
+        out[2][3] = 255;
+        out[3][0] = out[3][1] = out[3][2] = out[3][3] = 0;  /* 透明 */
+    }
+}
+
+static void bc3_alphas(const unsigned char* b, uint8_t out[8]) {
+    int a0 = b[0], a1 = b[1];
+    out[0] = (uint8_t)a0;
+    out[1] = (uint8_t)a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; ++i) out[i + 1] = (uint8_t)(((7 - i) * a0 + i * a1) / 7);
+    } else {
+        for (int i = 1; i < 5; ++i) out[i + 1] = (uint8_t)(((5 - i) * a0 + i * a1) / 5);
+        out[6] = 0;
+        out[7] = 255;
+    }
+}
+
+static unsigned char* bc_decode(const unsigned char* src, ENG_TexFormat f, int w, int h) {
+    unsigned char* dst = (unsigned char*)malloc((size_t)w * (size_t)h * 4);
+    if (!dst) return NULL;
+    size_t block = (f == ENG_TEXFMT_BC1) ? 8 : 16;
+    int bw = (w + 3) / 4, bh = (h + 3) / 4;
+    for (int by = 0; by < bh; ++by) {
+        for (int bx = 0; bx < bw; ++bx, src += block) {
+            const unsigned char* cb = (f == ENG_TEXFMT_BC3) ? src + 8 : src;
+            uint8_t  col[4][4], alpha[8];
+            uint32_t ci = rd32(cb + 4);
+            uint64_t ai = 0;
+            bc_colors(cb, f == ENG_TEXFMT_BC3, col);
+            if (f == ENG_TEXFMT_BC3) {
+                bc3_alphas(src, alpha);
+                for (int i = 0; i < 6; ++i) ai |= (uint64_t)src[2 + i] << (8 * i);
+            }
+            for (int py = 0; py < 4; ++py) {
+                int y = by * 4 + py;
+                if (y >= h) break;
+                for (int px = 0; px < 4; ++px) {
+                    int x = bx * 4 + px;
+                    if (x >= w) break;
+                    int t = py * 4 + px;
+                    unsigned char* d = dst + ((size_t)y * (size_t)w + (size_t)x) * 4;
+                    memcpy(d, col[(ci >> (2 * t)) & 3], 4);
+                    if (f == ENG_TEXFMT_BC3) d[3] = alpha[(ai >> (3 * t)) & 7];
+                }
+            }
+        }
+    }
+    return dst;
+}
+
+/* ── RGBA8 → 16bit 形式 ─────────────────────────────────*/
+static unsigned char* convert_16(const unsigned char* rgba, int w, int h, ENG_TexFormat f) {
+    size_t n = (size_t)w * (size_t)h;
+    uint16_t* out = (uint16_t*)malloc(n * 2);
+    if (!out) return NULL;
+    if (f == ENG_TEXFMT_RGB565) {
+        for (size_t i = 0; i < n; ++i, rgba += 4) {
+            out[i] = (uint16_t)((((rgba[0] * 31 + 127) / 255) << 11) |
+                                (((rgba[1] * 63 + 127) / 255) << 5) |
+                                 ((rgba[2] * 31 + 127) / 255));
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i, rgba += 4) {
+            out[i] = (uint16_t)((((rgba[0] * 15 + 127) / 255) << 12) |
+                                (((rgba[1] * 15 + 127) / 255) << 8) |
+                                (((rgba[2] * 15 + 127) / 255) << 4) |
+                                 ((rgba[3] * 15 + 127) / 255));
+        }
+    }
+    return (unsigned char*)out;
+}
+
+/* ── 乗算済みアルファ変換 ───────────────────────────────*/
+/* c' = round(c * a / 255)。x = c*a + 128 として (x + (x >> 8)) >> 8 で
+ * 0〜255*255 の範囲は正確に割れる (SIMD 版も同じ式なので結果は一致する)。
+ * dst == src で上書き変換してよい */
+static inline uint8_t mul255(unsigned c, unsigned a) {
+    unsigned x = c * a + 128;
+    return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+void eng_premultiply_rgba(unsigned char* dst, const unsigned char* src, size_t npx) {
+    size_t i = 0;
+#if defined(ENG_PREMUL_SSE2)
+    /* 4 画素ずつ: 16bit に広げて画素ごとの A を掛ける */
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i bias  = _mm_set1_epi16(128);
+    const __m128i amask = _mm_set1_epi32((int)0xFF000000u);
+    for (; i + 4 <= npx; i += 4) {
+        __m128i v  = _mm_loadu_si128((const __m128i*)(src + i * 4));
+        __m128i lo = _mm_unpacklo_epi8(v, zero);
+        __m128i hi = _mm_unpackhi_epi8(v, zero);
+        __m128i alo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, 0xFF), 0xFF);
+        __m128i ahi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, 0xFF), 0xFF);
+        lo = _mm_add_epi16(_mm_mullo_epi16(lo, alo), bias);
+        hi = _mm_add_epi16(_mm_mullo_epi16(hi, ahi), bias);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+        __m128i out = _mm_packus_epi16(lo, hi);
+        out = _mm_or_si128(_mm_andnot_si128(amask, out), _mm_and_si128(amask, v));
+        _mm_storeu_si128((__m128i*)(dst + i * 4), out);
+    }
+#elif defined(ENG_PREMUL_NEON)
+    /* 8 画素ずつ: チャンネル別に分解して掛ける */
+    for (; i + 8 <= npx; i += 8) {
+        uint8x8x4_t p = vld4_u8(src + i * 4);
+        for (int c = 0; c < 3; ++c) {
+            uint16x8_t x = vmull_u8(p.val[c], p.val[3]);
+            p.val[c] = vraddhn_u16(x, vrshrq_n_u16(x, 8));
+        }
+        vst4_u8(dst + i * 4, p);
+    }
+#endif
+    for (; i < npx; ++i) {
+        const unsigned char* s = src + i * 4;
+        unsigned char*       d = dst + i * 4;
+        unsigned a = s[3];
+        d[0] = mul255(s[0], a);
+        d[1] = mul255(s[1], a);
+        d[2] = mul255(s[2], a);
+        d[3] = (unsigned char)a;
+    }
+}
+
+/* ── RGBA8 → INDEX8 ─────────────────────────────────────*/
+/* 色は出現順に番号を振る (同じ画像からは常に同じパレットになる)。
+ * A = 0 の画素は色を問わず透明 1 色にまとめる */
+#define PAL_HASH 512
+
+static unsigned char* convert_index8(const unsigned char* rgba, size_t npx,
+                                     uint8_t* pal, int* count) {
+    unsigned char* out = (unsigned char*)malloc(npx ? npx : 1);
+    if (!out) return NULL;
+    uint32_t keys[PAL_HASH];
+    int16_t  vals[PAL_HASH];
+    memset(vals, -1, sizeof(vals));
+    int      n     = 0;
+    uint32_t last  = 0;
+    int      last_i = -1;
+    for (size_t i = 0; i < npx; ++i) {
+        uint32_t c;
+        memcpy(&c, rgba + i * 4, 4);
+        if (rgba[i * 4 + 3] == 0) c = 0;
+        if (c != last || last_i < 0) {
+            uint32_t h = (c * 2654435761u) >> 23;  /* 9bit */
+            while (vals[h] >= 0 && keys[h] != c) h = (h + 1) & (PAL_HASH - 1);
+            if (vals[h] < 0) {
+                if (n == 256) { free(out); return NULL; }
+                keys[h] = c;
+                vals[h] = (int16_t)n;
+                memcpy(pal + n * 4, &c, 4);
+                n++;
+            }
+            last   = c;
+            last_i = vals[h];
+        }
+        out[i] = (unsigned char)last_i;
+    }
+    *count = n;
+    return out;
+}
+
+static void free_owned(ENG_Image* img) {
+    if (img->owned_stbi) stbi_image_free(img->owned);
+    else                 free(img->owned);
+    img->owned      = NULL;
+    img->owned_stbi = false;
+}
+
+/* 単一レベルの所有データとして設定 */
+static void set_owned(ENG_Image* img, unsigned char* px, bool stbi,
+                      ENG_TexFormat f, int w, int h) {
+    img->owned         = px;
+    img->owned_stbi    = stbi;
+    img->base          = px;
+    img->format        = f;
+    img->w             = w;
+    img->h             = h;
+    img->levels        = 1;
+    img->level_off[0]  = 0;
+    img->level_size[0] = eng_texfmt_level_size(f, w, h);
+}
+
+/* ── 読込 ───────────────────────────────────────────────*/
+bool eng_image_load(const char* path, ENG_TexFormat want, bool premul,
+                    uint32_t gpu_caps, ENG_Image* img, const char** err) {
+    memset(img, 0, sizeof(*img));
+    *err = NULL;
+    if (!eng_file_map(path, &img->map)) { *err = "ファイルを開けません"; return false; }
+    const unsigned char* p = img->map.data;
+    size_t               n = img->map.size;
+
+    bool           container = false;
+    unsigned char* fast      = NULL;
+    int            fw = 0, fh = 0;
+    if (n >= 4 && memcmp(p, ENG_QOI_MAGIC, 4) == 0) {
+        if (!(fast = eng_qoi_decode(p, n, &fw, &fh, err))) goto fail;
+    } else if (n >= 4 && rd32(p) == ENG_HJLZ_MAGIC) {
+        if (!(fast = eng_hjlz_decode(p, n, &fw, &fh, err))) goto fail;
+    } else if (n >= 4 && memcmp(p, "DDS ", 4) == 0) {
+        if (!parse_dds(p, n, img, err)) goto fail;
+        container = true;
+    } else if (n >= sizeof(KTX_ID) && memcmp(p, KTX_ID, sizeof(KTX_ID)) == 0) {
+        if (!parse_ktx(p, n, img, err)) goto fail;
+        container = true;
+    }
+
+    if (container) {
+        if (img->w <= 0 || img->h <= 0) { *err = "画像サイズが不正"; goto fail; }
+        if (gpu_caps & ENG_TEXCAP(img->format)) {
+            img->base = p;  /* mmap 領域をそのまま転送 */
+            return true;
+        }
+        if (img->format == ENG_TEXFMT_BC7) {
+            *err = "BC7 非対応のドライバです (ソフトウェア展開は BC1/BC3 のみ)";
+            goto fail;
+        }
+        unsigned char* rgba = bc_decode(p + img->level_off[0], img->format, img->w, img->h);
+        if (!rgba) { *err = "メモリ不足"; goto fail; }
+        set_owned(img, rgba, false, ENG_TEXFMT_RGBA8, img->w, img->h);
+    } else if (fast) {
+        set_owned(img, fast, false, ENG_TEXFMT_RGBA8, fw, fh);
+    } else {
+        int w, h, ch;
+        unsigned char* px = stbi_load_from_memory(p, (int)n, &w, &h, &ch, 4);
+        if (!px) { *err = stbi_failure_reason(); goto fail; }
+        set_owned(img, px, true, ENG_TEXFMT_RGBA8, w, h);
+    }
+    eng_file_unmap(&img->map);  /* デコード済みなのでマッピングは不要 */
+
+    /* RGB565 はアルファを捨てるので掛けない。INDEX8 はパレット作成時に掛ける */
+    if (premul && want != ENG_TEXFMT_RGB565 && want != ENG_TEXFMT_INDEX8) {
+        eng_premultiply_rgba(img->owned, img->owned, (size_t)img->w * (size_t)img->h);
+    }
+
+    if (want == ENG_TEXFMT_INDEX8) {
+        unsigned char* idx = convert_index8(img->owned, (size_t)img->w * (size_t)img->h,
+                                            img->palette, &img->palette_count);
+        if (!idx) { *err = "INDEX8 にできません (256 色を超えています)"; goto fail; }
+        free_owned(img);
+        set_owned(img, idx, false, want, img->w, img->h);
+    } else if (want == ENG_TEXFMT_RGB565 || want == ENG_TEXFMT_RGBA4444) {
+        unsigned char* px16 = convert_16(img->owned, img->w, img->h, want);
+        if (!px16) { *err = "メモリ不足"; goto fail; }
+        free_owned(img);
+        set_owned(img, px16, false, want, img->w, img->h);
+    }
+    return true;
+
+fail:
+    eng_image_free(img);
+    return false;
+}
+
+void eng_image_free(ENG_Image* img) {
+    free_owned(img);
+    eng_file_unmap(&img->map);
+    memset(img, 0, sizeof(*img));
+}
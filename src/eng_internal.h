@@ -5,6 +5,7 @@
 #pragma once
 
 #include "eng_render.h"
+#include "eng_pack_format.h"
 
 #ifdef __APPLE__
   #define GL_SILENCE_DEPRECATION
@@ -26,46 +27,376 @@
 
 /* ── スプライトバッチ ───────────────────────────────────*/
 #define ENG_MAX_BATCH   4096   /* 1バッチ最大スプライト数 */
-#define ENG_MAX_TEXTURES 1024
-#define ENG_MAX_FONTS      16
 
 typedef struct {
     float x, y;   /* 位置 */
     float u, v;   /* UV */
     float r, g, b, a; /* 色 */
-} ENG_Vertex;  /* 32 bytes */
+    float pal;    /* パレット行 (ENG_DRAW_INDEXED のみ) */
+} ENG_Vertex;  /* 36 bytes */
+
+/* フラグメントシェーダーの u_mode */
+enum {
+    ENG_DRAW_COLOR   = 0,  /* 頂点色のみ */
+    ENG_DRAW_TEX     = 1,  /* テクスチャ × 頂点色 */
+    ENG_DRAW_INDEXED = 2,  /* R8 インデックス → パレット行 × 頂点色 */
+    ENG_DRAW_SDF     = 3,  /* R8 距離場 (0.5 = 輪郭) → 被覆率 × 頂点色 */
+};
 
 typedef struct {
     GLuint  vao, vbo, ibo;
     ENG_Vertex verts[ENG_MAX_BATCH * 4];
     int     quad_count;
     GLuint  current_tex;  /* 現在バインド中のテクスチャ */
-    bool    use_tex;
+    GLuint  current_sampler; /* 0 = テクスチャ自身のパラメータ */
+    GLuint  bound_sampler;   /* ユニット 0 に実際にバインド中のサンプラー */
+    int     mode;         /* ENG_DRAW_* */
     GLuint  prog;         /* シェーダープログラム */
     GLint   loc_proj;
-    GLint   loc_use_tex;
+    GLint   loc_mode;
     GLint   loc_tex;
+    GLint   loc_pal;
 } ENG_Batch;
 
+/* ── 世代付きハンドル表 ─────────────────────────────────*/
+/* ID = (世代 << 20) | (インデックス + 1)。世代は 1〜2047 で INT32 に収まる */
+#define ENG_SLOT_INDEX_BITS 20
+#define ENG_SLOT_INDEX_MASK ((1u << ENG_SLOT_INDEX_BITS) - 1)
+#define ENG_SLOT_GEN_MAX    2047
+
+typedef struct {
+    void**    chunks;     /* 256 要素ずつ (伸長してもアドレス不変) */
+    uint32_t* ids;        /* インデックスごとの現在の ID (0 = 空き) */
+    uint16_t* gens;       /* 次に払い出す世代 */
+    int32_t*  next_free;
+    size_t    elem_size;
+    int       cap;
+    int       count;
+    int32_t   free_head;  /* -1 = 空きなし */
+} ENG_SlotMap;
+
+/* ── ファイルマッピング (読込専用 mmap) ────────────────*/
+typedef struct {
+    const unsigned char* data;
+    size_t               size;
+    void*                file;     /* Windows: HANDLE */
+    void*                mapping;  /* Windows: HANDLE */
+} ENG_FileMap;
+
+/* ── サンプラー (filter × wrap × ミップ有無で共有) ─────*/
+#define ENG_SAMPLER_KEY(filter, wrap, mips) ((uint8_t)(((filter) * 3 + (wrap)) * 2 + ((mips) ? 1 : 0)))
+#define ENG_SAMPLER_WRAP(key) (((key) / 2) % 3)
+#define ENG_SAMPLER_KEYS 18
+
+/* ── 動的テクスチャ更新用 PBO リング ───────────────────*/
+#define ENG_PBO_RING 3
+
+/* ── パレット (ID = 行 + 1) ─────────────────────────────*/
+#define ENG_PALETTE_ROWS 256
+
+enum {
+    ENG_PAL_FREE      = 0,
+    ENG_PAL_USER      = 1,  /* eng_palette_create 等 (eng_palette_free で削除) */
+    ENG_PAL_TEX_OWNED = 2,  /* INDEX8 テクスチャ既定 (テクスチャと一緒に削除) */
+};
+
+typedef struct {
+    GLuint buf;
+    size_t cap;
+    GLsync fence;  /* 最後の転送の完了待ち (NULL = 未使用) */
+} ENG_PboSlot;
+
+/* ── デコード済み画像 (GL 非依存, ワーカーでも生成) ─────*/
+#define ENG_IMAGE_MAX_LEVELS 16
+#define ENG_TEXCAP(fmt)      (1u << (fmt))   /* tex_caps: GPU が直接扱える形式 */
+
+typedef struct {
+    ENG_TexFormat        format;
+    int                  w, h;
+    int                  levels;
+    const unsigned char* base;    /* level_off の基準 (owned または map.data) */
+    size_t               level_off[ENG_IMAGE_MAX_LEVELS];
+    size_t               level_size[ENG_IMAGE_MAX_LEVELS];
+    unsigned char*       owned;   /* デコード/変換結果 (NULL = mmap 直接) */
+    bool                 owned_stbi;
+    ENG_FileMap          map;
+    int                  palette_count;  /* INDEX8 のみ */
+    uint8_t              palette[256 * 4];
+} ENG_Image;
+
 /* ── テクスチャエントリ ─────────────────────────────────*/
 typedef struct {
     GLuint gl_id;
     int    w, h;
-    bool   used;
+    ENG_TexFormat format;  /* GPU 上の格納形式 */
+    ENG_TexFormat want;    /* 読込時の指定 (パスキャッシュのキーの一部) */
+    uint8_t samp_key;      /* ENG_SAMPLER_KEY (0 = 既定, サンプラーなし) */
+    bool    mipmaps;
+    bool   pending;   /* 非同期デコード中 (gl_id はまだ 0) */
+    int    atlas_page; /* 0 = 専用テクスチャ, n = アトラスページ n-1 */
+    float  u0, v0, u1, v1; /* gl_id 内のサブ矩形 (専用なら 0,0,1,1) */
+    int    refs;      /* 参照カウント (0 で解放) */
+    size_t bytes;     /* GPU 上の推定サイズ */
+    ENG_PaletteID palette; /* INDEX8: 読込時に作った自前のパレット (解放時に削除) */
+    char*  path;      /* パスキャッシュのキー (ファイル由来のみ) */
+    uint64_t path_hash;
+    ENG_TexID hash_next; /* 同一バケットの次 (0 = 終端) */
+    uint64_t last_used;  /* 最後に描画に使った r->tex_frame */
+    bool   evicted;   /* 予算超過で GPU から追い出し済み (次の使用で再読込) */
+    uint8_t  reload_fails;  /* 再読込の連続失敗回数 (失敗中は間隔を空けて試す) */
+    uint64_t reload_at;     /* 次に再読込を試してよい r->tex_frame */
+    ENG_PackID src_pack; /* パス由来でない場合の読込元パック (0 = なし) */
+    char*  src_name;  /* パック内の名前 */
 } ENG_TexEntry;
 
+/* 描画用に解決したテクスチャ (UV はサブ矩形へ写像済みで使う) */
+typedef struct {
+    GLuint gl_id;
+    GLuint sampler;  /* 0 = テクスチャ自身のパラメータ */
+    float  u0, v0, u1, v1;
+    int    mode;     /* ENG_DRAW_TEX / ENG_DRAW_INDEXED / ENG_DRAW_SDF */
+    int    pal_row;  /* INDEX8: 既定のパレット行 */
+} ENG_TexRef;
+
+/* ── テクスチャアトラス ─────────────────────────────────*/
+#define ENG_ATLAS_MAX_PAGES 16
+#define ENG_ATLAS_PAD        2   /* 画像周囲に複製する境界ピクセル幅 */
+
+typedef struct { int x, y, w; } ENG_SkyNode;
+
+typedef struct {
+    GLuint       tex;
+    int          size;
+    ENG_SkyNode* sky;
+    int          sky_count, sky_cap;
+    int          live;    /* このページ上の生存テクスチャ数 */
+} ENG_AtlasPage;
+
+typedef struct {
+    int           page_size;   /* 0 = 無効 */
+    ENG_AtlasPage pages[ENG_ATLAS_MAX_PAGES];
+    int           page_count;
+} ENG_Atlas;
+
+/* ── ワーカースレッドプール ─────────────────────────────*/
+typedef void (*ENG_JobRun)(void* arg);                   /* ワーカースレッド */
+typedef void (*ENG_JobDone)(void* arg, bool cancelled);  /* 描画スレッド */
+
+typedef struct ENG_Job {
+    ENG_JobRun      run;
+    ENG_JobDone     done;
+    void*           arg;
+    struct ENG_Job* next;
+} ENG_Job;
+
+typedef struct {
+    SDL_Thread** threads;
+    int          thread_count;   /* 0 = 未起動 */
+    SDL_mutex*   lock;
+    SDL_cond*    wake;
+    SDL_cond*    done_cv;        /* done リストに追加されたとき */
+    ENG_Job*     queue_head;     /* 未実行 */
+    ENG_Job*     queue_tail;
+    ENG_Job*     done_head;      /* 実行済み・done 未呼び出し */
+    ENG_Job*     done_tail;
+    int          pending;        /* 投入済みで done 未呼び出しの件数 */
+    bool         quit;
+} ENG_JobPool;
+
+/* ── グリフキャッシュ (全フォント共有の動的アトラス) ───*/
+#define ENG_GLYPH_PAGE_SIZE 1024
+#define ENG_GLYPH_MAX_PAGES 4
+#define ENG_GLYPH_PAD       1   /* グリフ間の透明な隙間 (LINEAR のにじみ防止) */
+
+typedef struct { int y, h, x; } ENG_GlyphShelf;  /* x = 次に置ける位置 */
+
+typedef struct {
+    GLuint          tex;
+    unsigned char*  pixels;     /* CPU 側の複製 (R8, PAGE_SIZE²)。行単位で転送する */
+    ENG_GlyphShelf* shelves;
+    int             shelf_count, shelf_cap;
+    int             dirty_y0, dirty_y1;  /* 未転送の行範囲 (y0 >= y1 = なし) */
+    uint32_t        epoch;      /* 破棄ごとに +1 (載っていたグリフを無効化) */
+    uint64_t        last_used;  /* 最後に描いた r->tex_frame */
+} ENG_GlyphPage;
+
+typedef struct {
+    ENG_GlyphPage pages[ENG_GLYPH_MAX_PAGES];
+    int           page_count;
+    bool          dirty;        /* どこかのページに未転送の行がある */
+} ENG_GlyphCache;
+
+/* フォントごとのグリフ (コードポイント → 寸法とページ上の位置) */
+typedef struct {
+    uint32_t cp;        /* 0 = 空きスロット */
+    uint32_t epoch;     /* ページの epoch と一致する間だけ page/x/y が有効 */
+    float    advance;
+    int16_t  xoff, yoff;  /* ベースライン原点からのビットマップ左上 */
+    uint16_t w, h;        /* 0 = 描く画素なし (空白) */
+    uint16_t x, y;
+    uint8_t  page;        /* ページ番号 + 1 (0 = 未ラスタライズ) */
+    uint8_t  pending;     /* ワーカーでラスタライズ中 (eng_set_async_glyphs) */
+} ENG_Glyph;
+
+/* ── グリフのディスクキャッシュ (.hjgc) ───────────────*/
+/*
+ * [ENG_FontCacheHeader][ENG_FontCacheGlyph × glyph_count (cp 昇順)][画素 (R8, w×h 詰め)]
+ * ファイル名はフェイス内容のハッシュ・サイズ・種別から作るので、フォントが
+ * 変われば別ファイルになり、古いものは読まれない。
+ */
+#define ENG_FONTCACHE_MAGIC   0x43474A48u  /* "HJGC" */
+#define ENG_FONTCACHE_VERSION 1u
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t face_hash;
+    float    size;         /* eng_font_metric_size (SDF は ENG_SDF_BASE_SIZE) */
+    uint32_t sdf;
+    uint32_t glyph_count;
+    uint32_t pixel_size;
+} ENG_FontCacheHeader;     /* 32 bytes */
+
+typedef struct {
+    uint32_t cp;
+    float    advance;
+    int16_t  xoff, yoff;
+    uint16_t w, h;
+    uint32_t offset;       /* 画素領域内の位置 */
+} ENG_FontCacheGlyph;      /* 20 bytes */
+
+/* キャッシュファイル 1 つ分。キー (フェイス・基準サイズ・種別) が同じフォントで共有し、
+ * SDF はサイズによらずフェイスごとに 1 つになる。最後のフォントが解放されたら書き出す */
+typedef struct ENG_FontDisk {
+    ENG_FileMap    map;
+    unsigned char* merged;       /* 先に解放されたフォントの分を足した内容 (NULL = map のまま) */
+    size_t         merged_size;
+    const ENG_FontCacheGlyph* glyphs;  /* cp 昇順 (map か merged を指す) */
+    uint32_t       count;
+    const unsigned char*      pix;
+    uint32_t       pix_size;
+    int            refs;
+} ENG_FontDisk;
+
+/* ── フォントフェイス ───────────────────────────────────*/
+/* TTF 1 ファイル分。サイズ違いのフォントはすべてこれを共有する */
+typedef struct {
+    char*          path;   /* ファイルから読んだときの共有キー (NULL = メモリから) */
+    ENG_FileMap    map;    /* ファイルは mmap したまま持つ */
+    unsigned char* owned;  /* メモリから作ったときの複製 */
+    size_t         size;   /* owned の長さ */
+    void*          info;   /* stbtt_fontinfo (malloc, スロット移動の影響を受けない) */
+    int            refs;   /* フォント数 + eng_load_face の呼び出し元 (api_ref) */
+    bool           api_ref;  /* eng_load_face で渡した参照 (何度開いても 1 つ) */
+    uint64_t       hash;   /* 内容のハッシュ (ディスクキャッシュのキー, 0 = 未計算) */
+} ENG_FontFace;
+
 /* ── フォントエントリ ───────────────────────────────────*/
-#define ENG_FONT_ATLAS_W 512
-#define ENG_FONT_ATLAS_H 512
+#define ENG_SDF_BASE_SIZE 48.0f  /* SDF グリフを作る基準の px 高さ (描画サイズとは無関係) */
+#define ENG_SDF_PAD       6      /* 輪郭の外側に持つ距離 (px)。太字化・縁取りの上限 */
 
 typedef struct {
-    GLuint  atlas_tex;
+    ENG_FontID self;  /* 非同期ラスタライズの完了時に引き直すための自分の ID */
     float   size;
-    bool    used;
-    /* stb_truetype baked chars: ASCII 32〜127 */
-    void*   baked; /* stbtt_bakedchar[96] */
+    /* ベイク済み (アセットパック): ASCII 32〜127 のみ */
+    GLuint  atlas_tex;
+    int     atlas_w, atlas_h;
+    void*   baked; /* stbtt_bakedchar[96] (NULL = TTF フォント) */
+    /* TTF: 使った文字だけグリフキャッシュへラスタライズする */
+    ENG_FaceID     face;   /* 参照を 1 つ持つ */
+    void*          info;   /* フェイスの stbtt_fontinfo (フェイスが所有) */
+    float          scale;  /* stbtt 単位 → グリフの px (SDF は ENG_SDF_BASE_SIZE 基準) */
+    bool           sdf;    /* 距離場グリフ: 1 つのキャッシュで任意のサイズ・回転を描く */
+    ENG_Glyph*     glyphs; /* オープンアドレス法, glyph_cap は 2 の累乗 */
+    int            glyph_cap, glyph_count;
+    /* ディスクキャッシュ (eng_fontcache.c, face_hash == 0 なら無効) */
+    uint64_t       face_hash;
+    struct ENG_FontDisk* disk;  /* 同じキーのフォントと共有 (NULL = 無し) */
+    bool           disk_stale;  /* キャッシュに無いグリフをラスタライズした (解放時に書き直す) */
 } ENG_FontEntry;
 
+/* グリフ寸法の基準サイズ (描画サイズ / これ = 拡大率) */
+static inline float eng_font_metric_size(const ENG_FontEntry* fe) {
+    return fe->sdf ? ENG_SDF_BASE_SIZE : fe->size;
+}
+/* フォント既定サイズで描くときの拡大率 */
+static inline float eng_font_k(const ENG_FontEntry* fe) {
+    return fe->size / eng_font_metric_size(fe);
+}
+
+/* 1 文字分の描画クワッド (eng_font_quad が埋める) */
+typedef struct {
+    float  x, y, w, h;
+    float  u0, v0, u1, v1;
+    GLuint tex;
+    int    mode;   /* ENG_DRAW_TEX / ENG_DRAW_SDF */
+    int    page;   /* グリフキャッシュのページ (-1 = ベイク済みアトラス) */
+} ENG_GlyphQuad;
+
+/* ── 行分割 (eng_text.c) ───────────────────────────────*/
+typedef struct {
+    uint32_t cp;
+    float    adv;          /* 既定サイズでの送り幅 (px) */
+} ENG_TextChar;
+
+typedef struct {
+    int   start, end;      /* 文字の範囲 [start, end) */
+    float w;               /* 行末の空白を除いた幅 */
+} ENG_TextLine;
+
+/* 行分割の結果。直前の折り返し描画/計測の分を 1 件覚えておき、同じ文字列なら使い回す */
+typedef struct {
+    ENG_FontID    font;
+    float         max_w;
+    char*         text;
+    size_t        text_cap;
+    ENG_TextChar* chars;
+    int           char_count, char_cap;
+    ENG_TextLine* lines;
+    int           line_count, line_cap;
+    float         w;       /* 最長行の幅 */
+} ENG_TextBreak;
+
+/* ── ビューポート (画面分割, eng_viewport.c) ───────────*/
+typedef struct {
+    int   x, y, w, h;          /* 画面上の矩形 (左上基準ピクセル) */
+    float cam_x, cam_y, cam_zoom, cam_rot_deg;
+    float view[6], view_inv[6];  /* eng_cam_build_view */
+    bool  used;
+} ENG_Viewport;
+
+/* 記録中に eng_batch_flush が 1 回送るはずだった分 (状態が同じなら前の分に継ぎ足す) */
+typedef struct {
+    int     first, quads;      /* 記録頂点中のクワッド範囲 */
+    GLuint  tex, sampler;
+    int     mode;              /* ENG_DRAW_* */
+    bool    premul, additive;
+    bool    clip;              /* eng_clip_begin の矩形 (ビューポート内の左上基準) */
+    int     clip_x, clip_y, clip_w, clip_h;
+} ENG_ViewportCmd;
+
+/* ── アセットパック ─────────────────────────────────────*/
+/* ID はスロットマップと同じ (世代 << ENG_SLOT_INDEX_BITS) | (スロット + 1)。
+ * 閉じて開き直したパックは別 ID になり、古い ID の参照先にならない */
+#define ENG_MAX_PACKS 8
+
+typedef struct {
+    ENG_FileMap           map;
+    const ENG_PackHeader* hdr;
+    const ENG_PackEntry*  entries;
+    const uint32_t*       buckets;
+    const char*           names;
+    bool                  used;
+    ENG_PackID            id;   /* 開いている間の ID (世代付き) */
+    uint16_t              gen;  /* 次に払い出す世代 (0 は 1 とみなす)。閉じるたびに進める */
+} ENG_PackFile;
+
+/* ── フレームペーシング ─────────────────────────────────*/
+#define ENG_FRAME_HISTORY 240   /* フレーム時間統計の窓 (フレーム数) */
+
+/* ── 解像度スケール ─────────────────────────────────────*/
+#define ENG_SCALE_QUERIES 4     /* GPU 時間計測クエリのリング */
+
 /* ── メインレンダラー構造体 ────────────────────────────*/
 struct ENG_Renderer {
     /* SDL */
@@ -89,9 +420,54 @@ struct ENG_Renderer {
     float    mouse_wheel;         /* このフレームのホイール量 */
     bool     quit_requested;
 
-    /* FPS キャップ */
+    /* FPS キャップ / フレームペーシング (eng_frame.c) */
     int      fps_cap;             /* 0=無制限 */
-    uint64_t frame_end_tick;      /* 前フレーム終了時刻 */
+    uint64_t pace_deadline;       /* 次のフレームを始める時刻 (0 = 未設定) */
+    int      pacing;              /* ENG_Pacing */
+    double   pace_spin_ms;        /* ハイブリッドで最後にスピンする長さ (寝過ごしから自動調整) */
+    int      vsync;               /* ENG_VSync */
+
+    /* フレーム時間 (スワップ間隔) の履歴 */
+    float    frame_ms[ENG_FRAME_HISTORY];
+    uint8_t  frame_hitch[ENG_FRAME_HISTORY];
+    int      frame_head, frame_count;
+    double   frame_sum_ms;        /* 履歴内の合計 */
+    int      frame_hitches;       /* 履歴内のヒッチ数 */
+    uint64_t hitch_total;
+    uint64_t last_swap_tick;
+
+    /* 固定ステップ (eng_frame.c) */
+    double   fixed_dt;            /* 1 ステップの秒数 (0 = 無効) */
+    int      fixed_max_steps;     /* 1 フレームに回す上限 */
+    double   fixed_acc;           /* まだ回していない時間 */
+    int      fixed_steps;         /* このフレームで回す数 */
+    double   fixed_alpha;         /* 描画の補間係数 */
+
+    /* ブレンド (eng_set_premultiplied_alpha / eng_set_additive) */
+    bool     premul_alpha;        /* 乗算済みアルファ: ONE, ONE_MINUS_SRC_ALPHA */
+    bool     additive;            /* 以降の描画を加算合成 */
+
+    /* パレット (INDEX8 テクスチャ用, 1 行 = 256 色) */
+    GLuint        pal_tex;            /* 256 × ENG_PALETTE_ROWS, 初回作成時に確保 */
+    uint8_t       pal_state[ENG_PALETTE_ROWS]; /* ENG_PAL_* */
+    ENG_PaletteID palette;            /* eng_set_palette (0 = テクスチャ既定) */
+
+    /* 解像度スケール (eng_scale.c): 場面を縮小 FBO に描いてからウィンドウへ拡大 */
+    float    render_scale;      /* 場面の倍率 (1 = ネイティブ, FBO を使わない) */
+    float    scale_min, scale_max;
+    float    scale_target_fps;  /* 自動調整の目標 (0 = 固定倍率) */
+    bool     scale_nearest;     /* 拡大時に最近傍 (ドット絵向け) */
+    float    target_scale;      /* 描画先ピクセル / 論理ピクセル (eng_gl_viewport 等) */
+    bool     scene_active;      /* このフレームの場面を FBO に描画中 */
+    GLuint   scene_fbo, scene_tex;
+    int      scene_alloc_w, scene_alloc_h;  /* 確保済み (倍率を下げても作り直さない) */
+    int      scene_w, scene_h;  /* このフレームで使う左下の範囲 */
+    GLuint   scale_queries[ENG_SCALE_QUERIES];  /* GL_TIME_ELAPSED (結果は数フレーム後に読む) */
+    bool     scale_query_busy[ENG_SCALE_QUERIES];
+    int      scale_query_next;
+    bool     scale_query_open;
+    double   scale_gpu_ms;      /* 場面の GPU 時間 (指数平滑) */
+    int      scale_cooldown;    /* 次の調整まで待つフレーム数 */
 
     /* クリッピング矩形 */
     bool     clip_active;
@@ -99,28 +475,235 @@ struct ENG_Renderer {
 
     /* カメラ */
     float cam_x, cam_y, cam_zoom, cam_rot_deg;
+    float view[6];      /* world→screen の 2x3 アフィン (eng_cam_update_view) */
+    float view_inv[6];  /* screen→world */
 
     /* バッチ */
     ENG_Batch batch;
 
-    /* テクスチャプール */
-    ENG_TexEntry textures[ENG_MAX_TEXTURES];
-    int          tex_count;
+    /* ビューポート (eng_viewport_begin〜end の間は描画を記録して各ビューポートで再生) */
+    ENG_Viewport     viewports[ENG_MAX_VIEWPORTS];
+    bool             vp_recording;
+    ENG_Vertex*      vp_verts;
+    int              vp_quads, vp_quad_cap;
+    ENG_ViewportCmd* vp_cmds;
+    int              vp_cmd_count, vp_cmd_cap;
+    GLuint           vp_vao, vp_vbo;    /* 初回の再生時に作成 */
+    int              vp_vbo_quads;      /* vp_vbo の確保量 */
+
+    /* テクスチャ (ENG_TexEntry の世代付きハンドル表) */
+    ENG_SlotMap  textures;
+
+    /* パスキャッシュ (パス → ID) と統計 */
+    ENG_TexID*   tex_buckets;       /* 0 = 空 */
+    int          tex_bucket_count;  /* 2 の累乗 */
+    int          tex_cached;
+    uint64_t     tex_cache_hits;
+    uint64_t     tex_cache_misses;
+    uint64_t     tex_resident_bytes;
+    uint64_t     tex_upload_ticks;  /* GL 転送に掛かった累計 (perf counter) */
+    uint64_t     tex_budget;        /* VRAM 予算 (0 = 無制限) */
+    uint64_t     tex_frame;         /* eng_tex_frame ごとに +1 (LRU の時刻) */
+    uint64_t     tex_evictions;
+    uint64_t     tex_reloads;
+    int          tex_pending;       /* デコードを投げて完了処理前のテクスチャ数 (グリフのジョブは含まない) */
+
+    /* アトラス */
+    ENG_Atlas    atlas;
+
+    /* 非同期ロード */
+    ENG_JobPool  jobs;
+    GLuint       placeholder_tex;   /* 読込中テクスチャの代替 (1x1 透明) */
+    uint32_t     tex_caps;          /* ENG_TEXCAP ビット (eng_tex_init で判定) */
+    GLuint       tex_samplers[ENG_SAMPLER_KEYS]; /* 遅延生成, [0] は常に 0 */
+    ENG_PboSlot  tex_pbo[ENG_PBO_RING];
+    int          tex_pbo_next;
+    double       upload_budget_ms;  /* 1 フレームあたりの GL 転送予算 */
+
+    /* フォント (ENG_FontEntry の世代付きハンドル表) */
+    ENG_SlotMap   fonts;
+    ENG_SlotMap   faces;   /* ENG_FontFace (eng_font.c) */
+    char*         font_cache_dir;  /* グリフのディスクキャッシュ (NULL = 無効) */
+    /* 非同期グリフ (eng_font.c) */
+    int           glyph_async;       /* 1 フレームにページへ載せる上限 (0 = 描画スレッドで同期) */
+    struct ENG_GlyphJob** glyph_ready;  /* ワーカーで完成し、載せるのを待つもの (先着順) */
+    int           glyph_ready_count, glyph_ready_cap;
+    uint32_t      glyph_misses;      /* 未完成で描けなかったグリフ数 (累計) */
+    uint32_t      glyph_placed;      /* 非同期で載せたグリフ数 (累計) */
+    ENG_GlyphCache glyphs;
+    ENG_SlotMap   texts;   /* テキストレイアウト (eng_text.c) */
+    ENG_TextBreak wrap;    /* eng_draw_text_wrap / eng_text_measure の直前の行分割 */
 
-    /* フォントプール */
-    ENG_FontEntry fonts[ENG_MAX_FONTS];
-    int           font_count;
+    /* アセットパック */
+    ENG_PackFile  packs[ENG_MAX_PACKS];
 };
 
+/* 頂点色をブレンドモードに合わせる。乗算済みなら RGB に A を掛け、
+ * 加算合成は A = 0 として送る (ONE, ONE_MINUS_SRC_ALPHA で dst がそのまま残る) */
+static inline void eng_blend_color(const ENG_Renderer* r,
+                                   float* cr, float* cg, float* cb, float* ca) {
+    if (!r->premul_alpha) return;
+    *cr *= *ca;
+    *cg *= *ca;
+    *cb *= *ca;
+    if (r->additive) *ca = 0.0f;
+}
+
+/* 論理ピクセル (win_w × win_h 基準, 下基準) の矩形を描画先のピクセルにして設定する。
+ * 縮小 FBO に描いている間は target_scale 倍、ウィンドウなら等倍。隣り合う矩形に隙間を作らないよう端を丸める */
+static inline void eng_scale_rect(const ENG_Renderer* r, int x, int y, int w, int h, int* out) {
+    float s = r->target_scale;
+    out[0] = (int)floorf((float)x * s + 0.5f);
+    out[1] = (int)floorf((float)y * s + 0.5f);
+    out[2] = (int)floorf((float)(x + w) * s + 0.5f) - out[0];
+    out[3] = (int)floorf((float)(y + h) * s + 0.5f) - out[1];
+}
+static inline void eng_gl_viewport(const ENG_Renderer* r, int x, int y, int w, int h) {
+    int v[4];
+    eng_scale_rect(r, x, y, w, h, v);
+    glViewport(v[0], v[1], v[2], v[3]);
+}
+static inline void eng_gl_scissor(const ENG_Renderer* r, int x, int y, int w, int h) {
+    int v[4];
+    eng_scale_rect(r, x, y, w, h, v);
+    glScissor(v[0], v[1], v[2], v[3]);
+}
+
 /* ── 内部関数 ───────────────────────────────────────────*/
 bool eng_shader_init(ENG_Batch* b);
 void eng_batch_init(ENG_Batch* b, GLuint prog);
 void eng_batch_flush(ENG_Renderer* r);
+void eng_batch_layout(void);  /* 現在の VAO に ENG_Vertex の属性を設定 */
+void eng_batch_blend(bool premul, bool additive);
+void eng_batch_push_verts(ENG_Renderer* r, GLuint tex, int mode,
+                          const ENG_Vertex* v, int quads);  /* 配置済みクワッドを複写 */
 void eng_batch_push_quad(ENG_Renderer* r,
     float x, float y, float w, float h,
     float u0, float v0, float u1, float v1,
     float rot, float ox, float oy,
     float cr, float cg, float cb, float ca,
-    GLuint tex, bool use_tex);
+    const ENG_TexRef* tex);  /* NULL = 頂点色のみ */
 void eng_update_proj(ENG_Renderer* r);
+void eng_cam_update_view(ENG_Renderer* r);  /* eng_update_proj から */
+void eng_cam_build_view(float cx, float cy, float zoom, float degrees,
+                        float* v, float* iv);  /* 2x3 の world→screen と逆行列 */
+void eng_view_proj(const float* v, int w, int h, float* proj);  /* ビュー行列 + w×h の正射影 */
+void     eng_slots_init(ENG_SlotMap* m, size_t elem_size);
+uint32_t eng_slots_alloc(ENG_SlotMap* m);                  /* 0 = 失敗, 要素はゼロ初期化 */
+void*    eng_slots_get(const ENG_SlotMap* m, uint32_t id); /* 無効/古い ID は NULL */
+void     eng_slots_free(ENG_SlotMap* m, uint32_t id);
+void*    eng_slots_at(const ENG_SlotMap* m, int idx);       /* 0 <= idx < cap */
+uint32_t eng_slots_id_at(const ENG_SlotMap* m, int idx);    /* 0 = 空き */
+void     eng_slots_destroy(ENG_SlotMap* m);
+
+bool   eng_texfmt_compressed(ENG_TexFormat f);
+size_t eng_texfmt_level_size(ENG_TexFormat f, int w, int h);
+bool   eng_image_load(const char* path, ENG_TexFormat want, bool premul,
+                      uint32_t gpu_caps, ENG_Image* img, const char** err);
+void   eng_premultiply_rgba(unsigned char* dst, const unsigned char* src, size_t npx);
+void   eng_image_free(ENG_Image* img);
+ENG_PaletteID eng_palette_new(ENG_Renderer* r, const unsigned char* rgba, int count,
+                              bool tex_owned);
+void          eng_palette_release(ENG_Renderer* r, ENG_PaletteID id);  /* テクスチャ所有分 */
+void          eng_palette_shutdown(ENG_Renderer* r);
+
+/* eng_codec.c — 戻り値は malloc した RGBA8 (NULL = 失敗, err に理由) */
+unsigned char* eng_qoi_decode(const unsigned char* p, size_t n, int* w, int* h,
+                              const char** err);
+unsigned char* eng_hjlz_decode(const unsigned char* p, size_t n, int* w, int* h,
+                               const char** err);
+bool           eng_lz4_decompress(const unsigned char* src, size_t n,
+                                  unsigned char* dst, size_t dst_size);
+
+void   eng_tex_init(ENG_Renderer* r);
 GLuint eng_tex_gl_id(ENG_Renderer* r, ENG_TexID id);
+bool   eng_tex_ref(ENG_Renderer* r, ENG_TexID id, ENG_TexRef* out);
+ENG_TexID eng_tex_create_rgba(ENG_Renderer* r, const unsigned char* rgba, int w, int h);
+void   eng_tex_set_pack_source(ENG_Renderer* r, ENG_TexID id, ENG_PackID pack, const char* name);
+void   eng_tex_frame(ENG_Renderer* r);  /* eng_update から: LRU 時刻を進めて予算超過分を追い出す */
+
+ENG_FontID eng_font_create_ttf(ENG_Renderer* r, const unsigned char* ttf, size_t len, float size);
+ENG_FontID eng_font_create_baked(ENG_Renderer* r, float size,
+                                 const unsigned char* atlas_pix, int aw, int ah,
+                                 const ENG_PackGlyph* glyphs);  /* 96 文字 (32〜127) */
+
+bool eng_file_map(const char* path, ENG_FileMap* m);
+void eng_file_unmap(ENG_FileMap* m);
+void eng_pack_shutdown(ENG_Renderer* r);
+const unsigned char* eng_pack_rgba(ENG_Renderer* r, ENG_PackID id, const char* name,
+                                   int* w, int* h);  /* パック内 RGBA8 (NULL = なし) */
+bool eng_pack_is_open(ENG_Renderer* r, ENG_PackID id);
+void eng_font_init(ENG_Renderer* r);
+void eng_font_shutdown(ENG_Renderer* r);
+ENG_FontEntry* eng_font_get(ENG_Renderer* r, ENG_FontID id);
+float eng_font_advance(ENG_FontEntry* fe, uint32_t cp, float k);
+bool  eng_font_quad(ENG_Renderer* r, ENG_FontEntry* fe, uint32_t cp,
+                    float x, float y, float k, ENG_GlyphQuad* q);
+
+bool  eng_font_render_glyph(const void* info, float scale, bool sdf, const ENG_Glyph* g,
+                            unsigned char* dst, int stride);  /* g->w × g->h を dst へ (スレッド安全) */
+void  eng_font_frame(ENG_Renderer* r);  /* eng_update から: 完成したグリフを予算内でページへ */
+
+/* eng_fontcache.c */
+uint64_t eng_fontcache_hash(const unsigned char* p, size_t n);  /* 0 は返さない */
+void     eng_fontcache_open(ENG_Renderer* r, ENG_FontEntry* fe);  /* face_hash 設定後に */
+const ENG_FontCacheGlyph* eng_fontcache_find(const ENG_FontEntry* fe, uint32_t cp);
+const unsigned char*      eng_fontcache_bitmap(const ENG_FontEntry* fe, const ENG_Glyph* g);
+void     eng_fontcache_close(ENG_Renderer* r, ENG_FontEntry* fe);  /* 新しいグリフがあれば保存 */
+
+void eng_text_init(ENG_Renderer* r);
+void eng_text_shutdown(ENG_Renderer* r);
+
+/* eng_frame.c */
+void eng_frame_pace(ENG_Renderer* r);     /* eng_update の最後: FPS 上限まで待つ */
+void eng_frame_swapped(ENG_Renderer* r);  /* eng_flush のスワップ直後: フレーム時間を記録 */
+void eng_frame_fixed(ENG_Renderer* r, double dt);  /* eng_update から: 実時間 dt 分のステップ数を決める */
+
+/* eng_scale.c */
+void eng_scale_frame_begin(ENG_Renderer* r);  /* eng_update の最後: 縮小 FBO へ切り替え */
+void eng_scale_resolve(ENG_Renderer* r);      /* 場面をウィンドウへ拡大 (eng_begin_ui / eng_flush) */
+void eng_scale_shutdown(ENG_Renderer* r);
+
+/* eng_viewport.c */
+void eng_viewport_record(ENG_Renderer* r);  /* 記録中の eng_batch_flush から */
+void eng_viewport_sync(ENG_Renderer* r, GLuint tex);  /* 記録分が tex を使っていれば今すぐ再生 (0 = 常に) */
+void eng_viewport_shutdown(ENG_Renderer* r);
+
+/* eng_glyph.c */
+int  eng_glyph_alloc(ENG_Renderer* r, int w, int h, int* x, int* y);  /* ページ番号 (-1 = 不可) */
+void eng_glyph_mark_dirty(ENG_Renderer* r, int page, int y, int h);
+void eng_glyph_upload(ENG_Renderer* r);    /* eng_batch_flush から: 未転送の行をまとめて転送 */
+void eng_glyph_shutdown(ENG_Renderer* r);
+
+/* UTF-8 を 1 文字読んで進める (不正な並びは U+FFFD, 終端では 0) */
+static inline uint32_t eng_utf8_next(const char** s) {
+    const unsigned char* p = (const unsigned char*)*s;
+    uint32_t c = p[0];
+    if (c < 0x80) { if (c) ++*s; return c; }
+    int n = (c >= 0xF0 && c < 0xF5) ? 3 : (c >= 0xE0 && c < 0xF0) ? 2 : (c >= 0xC2 && c < 0xE0) ? 1 : 0;
+    if (n == 0) { ++*s; return 0xFFFD; }
+    uint32_t min = n == 3 ? 0x10000 : n == 2 ? 0x800 : 0x80;
+    c &= 0x3Fu >> n;
+    for (int i = 1; i <= n; ++i) {
+        if ((p[i] & 0xC0) != 0x80) { *s += i; return 0xFFFD; }  /* 途中で切れた */
+        c = (c << 6) | (p[i] & 0x3F);
+    }
+    *s += n + 1;
+    if (c < min || c > 0x10FFFF || (c >= 0xD800 && c < 0xE000)) return 0xFFFD;
+    return c;
+}
+void   eng_tex_shutdown(ENG_Renderer* r);
+
+bool eng_jobs_start(ENG_JobPool* p, int threads);    /* threads<=0 で自動 */
+void eng_jobs_stop(ENG_JobPool* p);                  /* 残りは done(arg, true) */
+bool eng_jobs_submit(ENG_JobPool* p, ENG_JobRun run, ENG_JobDone done, void* arg);
+int  eng_jobs_pump(ENG_JobPool* p, double budget_ms); /* 完了分の done を実行 */
+int  eng_jobs_pending(ENG_JobPool* p);
+bool eng_jobs_help(ENG_JobPool* p);                  /* 未実行を 1 件呼び出し元で実行 */
+void eng_jobs_wait(ENG_JobPool* p, int timeout_ms);  /* 完了が届くまで待つ */
+
+bool   eng_atlas_add(ENG_Renderer* r, const unsigned char* rgba, int w, int h,
+                     int* out_page, float* out_uv);   /* 収まらなければ false */
+GLuint eng_atlas_page_tex(ENG_Renderer* r, int page);
+void   eng_atlas_release(ENG_Renderer* r, int page);
+void   eng_atlas_shutdown(ENG_Renderer* r);
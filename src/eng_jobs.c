@@ -0,0 +1,190 @@
+/**
+ * src/eng_jobs.c — ワーカースレッドプール (SDL_Thread)
+ *
+ * run()  はワーカースレッドで実行される (GL 呼び出し禁止)。
+ * done() は eng_jobs_pump() を呼んだスレッド = 描画スレッドで実行される。
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define ENG_JOBS_MAX_THREADS 32
+
+/* ── 完了リストへ移動 (lock 保持中) ────────────────────*/
+static void push_done(ENG_JobPool* p, ENG_Job* job) {
+    job->next = NULL;
+    if (p->done_tail) p->done_tail->next = job;
+    else              p->done_head = job;
+    p->done_tail = job;
+    SDL_CondSignal(p->done_cv);
+}
+
+/* ── ワーカーループ ─────────────────────────────────────*/
+static int worker_main(void* data) {
+    ENG_JobPool* p = (ENG_JobPool*)data;
+    SDL_LockMutex(p->lock);
+    for (;;) {
+        while (!p->queue_head && !p->quit) SDL_CondWait(p->wake, p->lock);
+        if (p->quit) break;
+
+        ENG_Job* job = p->queue_head;
+        p->queue_head = job->next;
+        if (!p->queue_head) p->queue_tail = NULL;
+        SDL_UnlockMutex(p->lock);
+
+        job->run(job->arg);
+
+        SDL_LockMutex(p->lock);
+        push_done(p, job);
+    }
+    SDL_UnlockMutex(p->lock);
+    return 0;
+}
+
+/* ── 起動 / 停止 ────────────────────────────────────────*/
+bool eng_jobs_start(ENG_JobPool* p, int threads) {
+    if (p->thread_count > 0) return true;
+    if (threads <= 0) {
+        /* 描画スレッド分を 1 つ残す */
+        threads = SDL_GetCPUCount() - 1;
+        if (threads < 1) threads = 1;
+        if (threads > ENG_JOBS_MAX_THREADS) threads = ENG_JOBS_MAX_THREADS;
+    }
+
+    p->lock    = SDL_CreateMutex();
+    p->wake    = SDL_CreateCond();
+    p->done_cv = SDL_CreateCond();
+    p->threads = (SDL_Thread**)calloc((size_t)threads, sizeof(SDL_Thread*));
+    if (!p->lock || !p->wake || !p->done_cv || !p->threads) {
+        fprintf(stderr, "[eng_render] ワーカー初期化失敗: %s\n", SDL_GetError());
+        eng_jobs_stop(p);
+        return false;
+    }
+    p->quit = false;
+    for (int i = 0; i < threads; ++i) {
+        p->threads[i] = SDL_CreateThread(worker_main, "eng_worker", p);
+        if (!p->threads[i]) break;
+        p->thread_count++;
+    }
+    if (p->thread_count == 0) {
+        fprintf(stderr, "[eng_render] ワーカー起動失敗: %s\n", SDL_GetError());
+        eng_jobs_stop(p);
+        return false;
+    }
+    return true;
+}
+
+void eng_jobs_stop(ENG_JobPool* p) {
+    if (p->lock) {
+        SDL_LockMutex(p->lock);
+        p->quit = true;
+        if (p->wake) SDL_CondBroadcast(p->wake);
+        SDL_UnlockMutex(p->lock);
+    }
+    for (int i = 0; i < p->thread_count; ++i) SDL_WaitThread(p->threads[i], NULL);
+
+    /* 未実行・未回収のジョブはキャンセル扱いで done を呼ぶ */
+    ENG_Job* lists[2] = { p->queue_head, p->done_head };
+    for (int l = 0; l < 2; ++l) {
+        ENG_Job* job = lists[l];
+        while (job) {
+            ENG_Job* next = job->next;
+            if (job->done) job->done(job->arg, true);
+            free(job);
+            job = next;
+        }
+    }
+
+    free(p->threads);
+    if (p->wake) SDL_DestroyCond(p->wake);
+    if (p->done_cv) SDL_DestroyCond(p->done_cv);
+    if (p->lock) SDL_DestroyMutex(p->lock);
+    memset(p, 0, sizeof(*p));
+}
+
+/* ── 投入 ───────────────────────────────────────────────*/
+bool eng_jobs_submit(ENG_JobPool* p, ENG_JobRun run, ENG_JobDone done, void* arg) {
+    if (!eng_jobs_start(p, 0)) return false;
+    ENG_Job* job = (ENG_Job*)malloc(sizeof(ENG_Job));
+    if (!job) return false;
+    job->run  = run;
+    job->done = done;
+    job->arg  = arg;
+    job->next = NULL;
+
+    SDL_LockMutex(p->lock);
+    if (p->queue_tail) p->queue_tail->next = job;
+    else               p->queue_head = job;
+    p->queue_tail = job;
+    p->pending++;
+    SDL_CondSignal(p->wake);
+    SDL_UnlockMutex(p->lock);
+    return true;
+}
+
+/* ── 完了ジョブの回収 (描画スレッド) ───────────────────*/
+static ENG_Job* take_done(ENG_JobPool* p) {
+    ENG_Job* job = NULL;
+    SDL_LockMutex(p->lock);
+    if (p->done_head) {
+        job = p->done_head;
+        p->done_head = job->next;
+        if (!p->done_head) p->done_tail = NULL;
+        p->pending--;
+    }
+    SDL_UnlockMutex(p->lock);
+    return job;
+}
+
+int eng_jobs_pump(ENG_JobPool* p, double budget_ms) {
+    if (p->thread_count == 0) return 0;
+    uint64_t freq  = SDL_GetPerformanceFrequency();
+    uint64_t start = SDL_GetPerformanceCounter();
+    uint64_t limit = (uint64_t)(budget_ms * (double)freq / 1000.0);
+    int n = 0;
+    /* 予算を超えても最低 1 件は処理して進行を保証する */
+    do {
+        ENG_Job* job = take_done(p);
+        if (!job) break;
+        if (job->done) job->done(job->arg, false);
+        free(job);
+        n++;
+    } while (SDL_GetPerformanceCounter() - start < limit);
+    return n;
+}
+
+/* ── 呼び出し元スレッドでの実行 / 待機 (一括ロード用) ─*/
+bool eng_jobs_help(ENG_JobPool* p) {
+    if (p->thread_count == 0) return false;
+    SDL_LockMutex(p->lock);
+    ENG_Job* job = p->queue_head;
+    if (job) {
+        p->queue_head = job->next;
+        if (!p->queue_head) p->queue_tail = NULL;
+    }
+    SDL_UnlockMutex(p->lock);
+    if (!job) return false;
+
+    job->run(job->arg);
+
+    SDL_LockMutex(p->lock);
+    push_done(p, job);
+    SDL_UnlockMutex(p->lock);
+    return true;
+}
+
+void eng_jobs_wait(ENG_JobPool* p, int timeout_ms) {
+    if (p->thread_count == 0) return;
+    SDL_LockMutex(p->lock);
+    if (!p->done_head) SDL_CondWaitTimeout(p->done_cv, p->lock, (Uint32)timeout_ms);
+    SDL_UnlockMutex(p->lock);
+}
+
+int eng_jobs_pending(ENG_JobPool* p) {
+    if (p->thread_count == 0) return 0;
+    SDL_LockMutex(p->lock);
+    int n = p->pending;
+    SDL_UnlockMutex(p->lock);
+    return n;
+}
@@ -0,0 +1,236 @@
+/**
+ * src/eng_pack.c — アセットパック (.hjpk) の mmap 読込
+ *
+ * パックは tools/eng_pack で事前に作成する (形式は eng_pack_format.h)。
+ * 画像はデコード済み RGBA、フォントはベイク済みアトラスを含むため、
+ * 実行時は名前ハッシュで O(1) に引いて GL へ転送するだけでよい。
+ */
+#include "eng_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
+
+/* ── ファイルマッピング ─────────────────────────────────*/
+bool eng_file_map(const char* path, ENG_FileMap* m) {
+    memset(m, 0, sizeof(*m));
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER sz;
+    if (!GetFileSizeEx(f, &sz) || sz.QuadPart == 0) { CloseHandle(f); return false; }
+    HANDLE mp = CreateFileMappingA(f, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mp) { CloseHandle(f); return false; }
+    void* p = MapViewOfFile(mp, FILE_MAP_READ, 0, 0, 0);
+    if (!p) { CloseHandle(mp); CloseHandle(f); return false; }
+    m->data    = (const unsigned char*)p;
+    m->size    = (size_t)sz.QuadPart;
+    m->file    = f;
+    m->mapping = mp;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) { close(fd); return false; }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);  /* マッピングは fd を閉じても有効 */
+    if (p == MAP_FAILED) return false;
+    m->data = (const unsigned char*)p;
+    m->size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void eng_file_unmap(ENG_FileMap* m) {
+    if (!m->data) return;
+#ifdef _WIN32
+    UnmapViewOfFile((LPCVOID)m->data);
+    CloseHandle((HANDLE)m->mapping);
+    CloseHandle((HANDLE)m->file);
+#else
+    munmap((void*)m->data, m->size);
+#endif
+    memset(m, 0, sizeof(*m));
+}
+
+/* ── 検証 ───────────────────────────────────────────────*/
+static bool range_ok(const ENG_FileMap* m, uint64_t off, uint64_t size) {
+    return off <= m->size && size <= m->size - off;
+}
+
+static bool validate(ENG_PackFile* pk) {
+    const ENG_FileMap* m = &pk->map;
+    if (m->size < sizeof(ENG_PackHeader)) return false;
+    const ENG_PackHeader* h = (const ENG_PackHeader*)m->data;
+    if (h->magic != ENG_PACK_MAGIC || h->version != ENG_PACK_VERSION) return false;
+    if (h->file_size != m->size) return false;
+    if (h->bucket_count == 0 || (h->bucket_count & (h->bucket_count - 1))) return false;
+    if (h->entry_count >= h->bucket_count) return false;
+    if (!range_ok(m, h->entries_offset, (uint64_t)h->entry_count * sizeof(ENG_PackEntry))) return false;
+    if (!range_ok(m, h->buckets_offset, (uint64_t)h->bucket_count * sizeof(uint32_t))) return false;
+    if (h->names_offset > m->size) return false;
+
+    pk->hdr     = h;
+    pk->entries = (const ENG_PackEntry*)(m->data + h->entries_offset);
+    pk->buckets = (const uint32_t*)(m->data + h->buckets_offset);
+    pk->names   = (const char*)(m->data + h->names_offset);
+
+    size_t names_size = m->size - (size_t)h->names_offset;
+    for (uint32_t i = 0; i < h->entry_count; ++i) {
+        const ENG_PackEntry* e = &pk->entries[i];
+        if (e->name_offset >= names_size) return false;
+        if (!memchr(pk->names + e->name_offset, '\0', names_size - e->name_offset)) return false;
+        if (!range_ok(m, e->data_offset, e->data_size)) return false;
+        if (!range_ok(m, e->aux_offset, e->aux_size)) return false;
+    }
+    /* 空きバケットが無いと、無い名前の探索が止まらない */
+    uint32_t empty = 0;
+    for (uint32_t i = 0; i < h->bucket_count; ++i) {
+        if (pk->buckets[i] > h->entry_count) return false;
+        empty += pk->buckets[i] == 0;
+    }
+    return empty > 0;
+}
+
+/* ── 名前解決 (オープンアドレス法, O(1)) ────────────────*/
+static const ENG_PackEntry* pack_find(const ENG_PackFile* pk, const char* name) {
+    uint64_t hash = eng_pack_hash(name);
+    uint32_t mask = pk->hdr->bucket_count - 1;
+    uint32_t b    = (uint32_t)hash & mask;
+    for (uint32_t probe = 0; probe < pk->hdr->bucket_count; ++probe, b = (b + 1) & mask) {
+        uint32_t idx = pk->buckets[b];
+        if (idx == 0) return NULL;
+        const ENG_PackEntry* e = &pk->entries[idx - 1];
+        if (e->name_hash == hash && strcmp(pk->names + e->name_offset, name) == 0) return e;
+    }
+    return NULL;
+}
+
+static ENG_PackFile* get_pack(ENG_Renderer* r, ENG_PackID id) {
+    uint32_t slot = (id & ENG_SLOT_INDEX_MASK) - 1;
+    if (!r || id == 0 || slot >= ENG_MAX_PACKS) return NULL;
+    ENG_PackFile* pk = &r->packs[slot];
+    return pk->used && pk->id == id ? pk : NULL;
+}
+
+/* 世代だけ残して空にする */
+static void pack_reset(ENG_PackFile* pk) {
+    uint16_t gen = pk->gen;
+    memset(pk, 0, sizeof(*pk));
+    pk->gen = gen;
+}
+
+/* ── 公開 API ───────────────────────────────────────────*/
+ENG_PackID eng_pack_open(ENG_Renderer* r, const char* path) {
+    if (!r || !path) return 0;
+    int slot = -1;
+    for (int i = 0; i < ENG_MAX_PACKS; ++i) {
+        if (!r->packs[i].used) { slot = i; break; }
+    }
+    if (slot < 0) {
+        fprintf(stderr, "[eng_render] パックスロット不足\n");
+        return 0;
+    }
+
+    ENG_PackFile* pk = &r->packs[slot];
+    pack_reset(pk);
+    if (!eng_file_map(path, &pk->map)) {
+        fprintf(stderr, "[eng_render] パック読込失敗: %s\n", path);
+        return 0;
+    }
+    if (!validate(pk)) {
+        fprintf(stderr, "[eng_render] パック形式が不正です: %s\n", path);
+        eng_file_unmap(&pk->map);
+        pack_reset(pk);
+        return 0;
+    }
+    if (!pk->gen) pk->gen = 1;
+    pk->used = true;
+    pk->id   = ((ENG_PackID)pk->gen << ENG_SLOT_INDEX_BITS) | (ENG_PackID)(slot + 1);
+    return pk->id;
+}
+
+void eng_pack_close(ENG_Renderer* r, ENG_PackID id) {
+    ENG_PackFile* pk = get_pack(r, id);
+    if (!pk) return;
+    eng_file_unmap(&pk->map);
+    pack_reset(pk);
+    pk->gen = (uint16_t)(pk->gen % ENG_SLOT_GEN_MAX + 1);  /* 古い ID を無効にする */
+}
+
+bool eng_pack_is_open(ENG_Renderer* r, ENG_PackID id) {
+    return get_pack(r, id) != NULL;
+}
+
+bool eng_pack_contains(ENG_Renderer* r, ENG_PackID id, const char* name) {
+    ENG_PackFile* pk = get_pack(r, id);
+    return pk && name && pack_find(pk, name) != NULL;
+}
+
+/* パック内の RGBA8 画像 (mmap 領域を直接指す)。追い出したテクスチャの再読込にも使う */
+const unsigned char* eng_pack_rgba(ENG_Renderer* r, ENG_PackID id, const char* name,
+                                   int* w, int* h) {
+    ENG_PackFile* pk = get_pack(r, id);
+    if (!pk || !name) return NULL;
+    const ENG_PackEntry* e = pack_find(pk, name);
+    if (!e || e->type != ENG_PACK_RGBA8 ||
+        e->data_size != (uint64_t)e->width * e->height * 4) return NULL;
+    *w = (int)e->width;
+    *h = (int)e->height;
+    return pk->map.data + e->data_offset;
+}
+
+ENG_TexID eng_pack_load_texture(ENG_Renderer* r, ENG_PackID id, const char* name) {
+    if (!get_pack(r, id) || !name) return 0;
+    int w, h;
+    const unsigned char* px = eng_pack_rgba(r, id, name, &w, &h);
+    if (!px) {
+        fprintf(stderr, "[eng_render] パック内に画像がありません: %s\n", name);
+        return 0;
+    }
+    ENG_TexID tex = eng_tex_create_rgba(r, px, w, h);
+    eng_tex_set_pack_source(r, tex, id, name);
+    return tex;
+}
+
+ENG_FontID eng_pack_load_font(ENG_Renderer* r, ENG_PackID id, const char* name, float size) {
+    ENG_PackFile* pk = get_pack(r, id);
+    if (!pk || !name) return 0;
+
+    /* ベイク済みがあれば転送のみ */
+    char baked_name[ENG_PACK_FONT_NAME_MAX];
+    int  n = snprintf(baked_name, sizeof(baked_name), ENG_PACK_FONT_NAME_FMT, name, (double)size);
+    const ENG_PackEntry* e = n >= 0 && (size_t)n < sizeof(baked_name) ? pack_find(pk, baked_name) : NULL;
+    if (e && e->type == ENG_PACK_FONT_BAKED && e->first_char == 32 &&
+        e->aux_size == 96 * sizeof(ENG_PackGlyph) &&
+        e->data_size == (uint64_t)e->width * e->height) {
+        return eng_font_create_baked(r, e->font_size, pk->map.data + e->data_offset,
+                                     (int)e->width, (int)e->height,
+                                     (const ENG_PackGlyph*)(pk->map.data + e->aux_offset));
+    }
+
+    /* 無ければマップ済み TTF から (ファイル読込は不要、グリフは描画時に作る) */
+    e = pack_find(pk, name);
+    if (e && e->type == ENG_PACK_FONT_TTF) {
+        return eng_font_create_ttf(r, pk->map.data + e->data_offset,
+                                   (size_t)e->data_size, size);
+    }
+    fprintf(stderr, "[eng_render] パック内にフォントがありません: %s\n", name);
+    return 0;
+}
+
+/* ── 終了処理 (eng_destroy から) ───────────────────────*/
+void eng_pack_shutdown(ENG_Renderer* r) {
+    for (int i = 0; i < ENG_MAX_PACKS; ++i) {
+        if (r->packs[i].used) eng_file_unmap(&r->packs[i].map);
+    }
+    memset(r->packs, 0, sizeof(r->packs));
+}
@@ -0,0 +1,71 @@
+/**
+ * eng_pack_format.h — アセットパック (.hjpk) のファイル形式
+ *
+ * tools/eng_pack.c (書き出し) と src/eng_pack.c (mmap で読込) で共有する。
+ * 全フィールドはリトルエンディアン。データ本体は ENG_PACK_ALIGN 境界に
+ * 配置され、mmap した領域からそのまま glTexImage2D に渡せる。
+ *
+ *   [ENG_PackHeader]
+ *   [ENG_PackEntry × entry_count]
+ *   [uint32_t bucket × bucket_count]   名前ハッシュ表 (entry index + 1, 0 = 空)
+ *   [名前文字列 (NUL 終端) の連結]
+ *   [データ …]
+ */
+#pragma once
+
+#include <stdint.h>
+
+#define ENG_PACK_MAGIC   0x4B504A48u   /* "HJPK" */
+#define ENG_PACK_VERSION 1u
+#define ENG_PACK_ALIGN   64u
+
+typedef enum {
+    ENG_PACK_RGBA8      = 1,  /* デコード済み RGBA8 (width × height × 4) */
+    ENG_PACK_FONT_TTF   = 2,  /* TTF/OTF ファイルそのまま */
+    ENG_PACK_FONT_BAKED = 3,  /* ベイク済みアトラス (R8) + aux に ENG_PackGlyph[] */
+} ENG_PackType;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t bucket_count;     /* 2 の累乗 */
+    uint64_t entries_offset;
+    uint64_t buckets_offset;
+    uint64_t names_offset;
+    uint64_t file_size;
+} ENG_PackHeader;              /* 48 bytes */
+
+typedef struct {
+    uint64_t name_hash;        /* eng_pack_hash(name) */
+    uint32_t name_offset;      /* 名前領域内のオフセット */
+    uint32_t type;             /* ENG_PackType */
+    uint32_t width, height;    /* RGBA8 / FONT_BAKED のアトラス寸法 */
+    uint64_t data_offset;      /* ファイル先頭から (ENG_PACK_ALIGN 境界) */
+    uint64_t data_size;
+    uint64_t aux_offset;       /* FONT_BAKED: グリフ表 */
+    uint64_t aux_size;
+    float    font_size;        /* FONT_BAKED: ベイク時のピクセルサイズ */
+    uint32_t first_char;       /* FONT_BAKED: グリフ表先頭のコードポイント */
+} ENG_PackEntry;               /* 64 bytes */
+
+/* stbtt_bakedchar と同一レイアウト */
+typedef struct {
+    uint16_t x0, y0, x1, y1;
+    float    xoff, yoff, xadvance;
+} ENG_PackGlyph;               /* 20 bytes */
+
+/* ベイク済みフォントのエントリ名: "<ttf 名>@<サイズ>" */
+#define ENG_PACK_FONT_NAME_FMT "%s@%g"
+/* フォントのエントリ名の上限 (終端 NUL を含む)。ツールはこれに収まらない名前を書かない */
+#define ENG_PACK_FONT_NAME_MAX 512
+
+/* 名前ハッシュ (FNV-1a 64bit) */
+static inline uint64_t eng_pack_hash(const char* s) {
+    uint64_t h = 1469598103934665603ull;
+    for (; *s; ++s) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ull;
+    }
+    return h;
+}
@@ -0,0 +1,147 @@
+/**
+ * src/eng_palette.c — INDEX8 テクスチャ用のパレット
+ *
+ * 全パレットを 1 枚の RGBA8 テクスチャ (256 色 × ENG_PALETTE_ROWS 行) に置き、
+ * 行番号を頂点に載せてシェーダーで引く (eng_shader.c の u_mode == 2)。
+ * 色違いのスプライトは同じ INDEX8 テクスチャ + 別の行で描けるので、
+ * VRAM は 1 枚分で済み、バッチも途切れない。
+ */
+#include "eng_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+static bool ensure_tex(ENG_Renderer* r) {
+    if (r->pal_tex) return true;
+    glGenTextures(1, &r->pal_tex);
+    if (!r->pal_tex) return false;
+    glBindTexture(GL_TEXTURE_2D, r->pal_tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 256, ENG_PALETTE_ROWS, 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return true;
+}
+
+static inline int row_of(const ENG_Renderer* r, ENG_PaletteID id) {
+    if (id == 0 || id > ENG_PALETTE_ROWS || r->pal_state[id - 1] == ENG_PAL_FREE) return -1;
+    return (int)id - 1;
+}
+
+/* 行 row の x〜x+n を書換える。描画待ちのクワッドは古い色で描くべきなので先に送る */
+static void upload(ENG_Renderer* r, int row, int x, int n, const unsigned char* rgba) {
+    if (r->batch.quad_count > 0 && r->batch.mode == ENG_DRAW_INDEXED) eng_batch_flush(r);
+    eng_viewport_sync(r, 0);
+    glBindTexture(GL_TEXTURE_2D, r->pal_tex);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, row, n, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+/* ── 作成 / 削除 ───────────────────────────────────────*/
+ENG_PaletteID eng_palette_new(ENG_Renderer* r, const unsigned char* rgba, int count,
+                              bool tex_owned) {
+    if (!r || !rgba || count <= 0 || count > 256 || !ensure_tex(r)) return 0;
+    int row = -1;
+    for (int i = 0; i < ENG_PALETTE_ROWS; ++i) {
+        if (r->pal_state[i] == ENG_PAL_FREE) { row = i; break; }
+    }
+    if (row < 0) {
+        fprintf(stderr, "[eng_render] パレット行が不足しています (最大 %d)\n", ENG_PALETTE_ROWS);
+        return 0;
+    }
+
+    unsigned char line[256 * 4];
+    memset(line, 0, sizeof(line));
+    memcpy(line, rgba, (size_t)count * 4);
+    if (r->premul_alpha) eng_premultiply_rgba(line, line, 256);
+    upload(r, row, 0, 256, line);
+    r->pal_state[row] = tex_owned ? ENG_PAL_TEX_OWNED : ENG_PAL_USER;
+    return (ENG_PaletteID)(row + 1);
+}
+
+ENG_PaletteID eng_palette_create(ENG_Renderer* r, const unsigned char* rgba, int count) {
+    return eng_palette_new(r, rgba, count, false);
+}
+
+static void drop(ENG_Renderer* r, ENG_PaletteID id, uint8_t state) {
+    int row = r ? row_of(r, id) : -1;
+    if (row < 0 || r->pal_state[row] != state) return;
+    r->pal_state[row] = ENG_PAL_FREE;
+    if (r->palette == id) r->palette = 0;
+}
+
+void eng_palette_free(ENG_Renderer* r, ENG_PaletteID id) {
+    drop(r, id, ENG_PAL_USER);  /* テクスチャ既定の行はテクスチャと一緒に消える */
+}
+
+void eng_palette_release(ENG_Renderer* r, ENG_PaletteID id) {
+    drop(r, id, ENG_PAL_TEX_OWNED);
+}
+
+/* ── 色違い画像から作成 ─────────────────────────────────*/
+/* 基準画像を INDEX8 にしたときの番号ごとに、同じ位置の色違い画像の色を拾う */
+ENG_PaletteID eng_palette_load_variant(ENG_Renderer* r, const char* base_path,
+                                       const char* variant_path) {
+    if (!r || !base_path || !variant_path) return 0;
+    ENG_Image   base, var;
+    const char* err;
+    if (!eng_image_load(base_path, ENG_TEXFMT_INDEX8, false, 0, &base, &err)) {
+        fprintf(stderr, "[eng_render] パレット基準画像の読込失敗: %s — %s\n",
+                base_path, err ? err : "unknown");
+        return 0;
+    }
+    if (!eng_image_load(variant_path, ENG_TEXFMT_RGBA8, false, 0, &var, &err)) {
+        fprintf(stderr, "[eng_render] 色違い画像の読込失敗: %s — %s\n",
+                variant_path, err ? err : "unknown");
+        eng_image_free(&base);
+        return 0;
+    }
+
+    ENG_PaletteID id = 0;
+    if (var.format != ENG_TEXFMT_RGBA8 || var.w != base.w || var.h != base.h) {
+        fprintf(stderr, "[eng_render] 色違い画像の寸法/形式が基準と一致しません: %s\n",
+                variant_path);
+    } else {
+        unsigned char        pal[256 * 4];
+        const unsigned char* idx = base.base + base.level_off[0];
+        const unsigned char* px  = var.base + var.level_off[0];
+        size_t               npx = (size_t)base.w * (size_t)base.h;
+        memcpy(pal, base.palette, sizeof(pal));
+        for (size_t i = 0; i < npx; ++i) memcpy(pal + idx[i] * 4, px + i * 4, 4);
+        id = eng_palette_new(r, pal, base.palette_count, false);
+    }
+    eng_image_free(&base);
+    eng_image_free(&var);
+    return id;
+}
+
+/* ── 編集 / 選択 ────────────────────────────────────────*/
+static inline unsigned char to_u8(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return (unsigned char)(v * 255.0f + 0.5f);
+}
+
+bool eng_palette_set_color(ENG_Renderer* r, ENG_PaletteID id, int index,
+                           float cr, float cg, float cb, float ca) {
+    int row = r ? row_of(r, id) : -1;
+    if (row < 0 || index < 0 || index > 255) return false;
+    unsigned char c[4] = { to_u8(cr), to_u8(cg), to_u8(cb), to_u8(ca) };
+    if (r->premul_alpha) eng_premultiply_rgba(c, c, 1);
+    upload(r, row, index, 1, c);
+    return true;
+}
+
+void eng_set_palette(ENG_Renderer* r, ENG_PaletteID id) {
+    if (!r) return;
+    r->palette = row_of(r, id) >= 0 ? id : 0;
+}
+
+/* ── 終了処理 (eng_destroy から) ───────────────────────*/
+void eng_palette_shutdown(ENG_Renderer* r) {
+    if (r->pal_tex) glDeleteTextures(1, &r->pal_tex);
+    r->pal_tex = 0;
+    memset(r->pal_state, 0, sizeof(r->pal_state));
+    r->palette = 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * src/eng_scale.c — 解像度スケール (縮小 FBO に描いてウィンドウへ拡大)
+ *
+ * 倍率 < 1 のあいだ、eng_update の最後に場面用 FBO を描画先にし、
+ * glViewport / glScissor を倍率分だけ縮める (論理座標・投影行列・マウス座標はそのまま)。
+ * eng_begin_ui か eng_flush で glBlitFramebuffer により最近傍 / 線形でウィンドウへ拡大する。
+ *
+ * 自動調整では場面の GPU 時間を GL_TIME_ELAPSED で測り (結果は数フレーム遅れて読む)、
+ * 塗る画素数 ∝ 倍率² として目標フレーム時間に収まる倍率へ寄せる。
+ * FBO は上限倍率の寸法で確保し、倍率を変えても左下の使う範囲を変えるだけで作り直さない。
+ */
+#include "eng_internal.h"
+#include <stdio.h>
+#include <math.h>
+
+#define SCALE_MIN_LIMIT 0.25f  /* これ未満は指定できない */
+#define SCALE_STEP      32.0f  /* 倍率は 1/32 刻み */
+#define SCALE_HEADROOM  0.8    /* 目標フレーム時間のうち場面に使ってよい割合 */
+#define SCALE_COOLDOWN  30     /* 倍率を変えてから次に判断するまでのフレーム数 */
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : v > hi ? hi : v;
+}
+
+/* 現在の描画先の倍率で viewport / scissor を張り直す */
+static void apply_target(ENG_Renderer* r) {
+    eng_gl_viewport(r, 0, 0, r->win_w, r->win_h);
+    if (r->clip_active) eng_gl_scissor(r, r->clip_x, r->clip_y, r->clip_w, r->clip_h);
+}
+
+/* ── 設定 ───────────────────────────────────────────────*/
+void eng_set_render_scale(ENG_Renderer* r, float scale) {
+    if (!r) return;
+    r->render_scale     = clampf(scale, SCALE_MIN_LIMIT, 1.0f);
+    r->scale_target_fps = 0.0f;  /* 次のフレームから */
+}
+
+void eng_set_render_scale_auto(ENG_Renderer* r, float target_fps, float min_scale, float max_scale) {
+    if (!r) return;
+    if (target_fps <= 0.0f) {
+        r->scale_target_fps = 0.0f;
+        return;
+    }
+    r->scale_min = clampf(min_scale, SCALE_MIN_LIMIT, 1.0f);
+    r->scale_max = clampf(max_scale, r->scale_min, 1.0f);
+    r->scale_target_fps = target_fps;
+    r->render_scale     = clampf(r->render_scale, r->scale_min, r->scale_max);
+    r->scale_gpu_ms     = 0.0;
+    r->scale_cooldown   = 0;
+}
+
+void eng_set_render_scale_nearest(ENG_Renderer* r, bool nearest) {
+    if (r) r->scale_nearest = nearest;
+}
+
+float  eng_render_scale(ENG_Renderer* r)  { return r ? r->render_scale : 1.0f; }
+double eng_render_gpu_ms(ENG_Renderer* r) { return r ? r->scale_gpu_ms : 0.0; }
+
+/* ── 場面用 FBO ─────────────────────────────────────────*/
+static void scene_release(ENG_Renderer* r) {
+    if (r->scene_fbo) glDeleteFramebuffers(1, &r->scene_fbo);
+    if (r->scene_tex) glDeleteTextures(1, &r->scene_tex);
+    r->scene_fbo = r->scene_tex = 0;
+    r->scene_alloc_w = r->scene_alloc_h = 0;
+}
+
+/* w×h が収まる FBO を用意する。自動調整中は上限倍率の寸法で確保しておく */
+static bool scene_ensure(ENG_Renderer* r, int w, int h) {
+    float cap = r->scale_target_fps > 0.0f ? r->scale_max : r->render_scale;
+    int   aw  = (int)ceilf((float)r->win_w * cap), ah = (int)ceilf((float)r->win_h * cap);
+    if (aw < w) aw = w;
+    if (ah < h) ah = h;
+    if (r->scene_fbo && r->scene_alloc_w >= w && r->scene_alloc_h >= h &&
+        r->scene_alloc_w <= aw && r->scene_alloc_h <= ah) return true;
+
+    scene_release(r);
+    glGenTextures(1, &r->scene_tex);
+    glBindTexture(GL_TEXTURE_2D, r->scene_tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, aw, ah, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &r->scene_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, r->scene_fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, r->scene_tex, 0);
+    GLenum st = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (st != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[eng_render] 解像度スケール用 FBO を作れません (0x%x)、ネイティブで描きます\n", st);
+        scene_release(r);
+        r->render_scale     = 1.0f;
+        r->scale_target_fps = 0.0f;
+        return false;
+    }
+    r->scene_alloc_w = aw;
+    r->scene_alloc_h = ah;
+    return true;
+}
+
+/* ── 自動調整 ───────────────────────────────────────────*/
+/* 届いた計測結果を平滑化し、目標から外れていれば倍率を動かす */
+static void scale_poll(ENG_Renderer* r) {
+    for (int i = 0; i < ENG_SCALE_QUERIES; ++i) {
+        if (!r->scale_query_busy[i]) continue;
+        GLint avail = 0;
+        glGetQueryObjectiv(r->scale_queries[i], GL_QUERY_RESULT_AVAILABLE, &avail);
+        if (!avail) continue;
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(r->scale_queries[i], GL_QUERY_RESULT, &ns);
+        r->scale_query_busy[i] = false;
+        double ms = (double)ns / 1.0e6;
+        r->scale_gpu_ms = r->scale_gpu_ms > 0.0 ? r->scale_gpu_ms * 0.8 + ms * 0.2 : ms;
+    }
+    if (r->scale_target_fps <= 0.0f || r->scale_gpu_ms <= 0.0) return;
+    if (r->scale_cooldown > 0) {
+        r->scale_cooldown--;
+        return;
+    }
+
+    double budget = 1000.0 / r->scale_target_fps * SCALE_HEADROOM;
+    float  s      = r->render_scale;
+    float  ideal  = s * (float)sqrt(budget / r->scale_gpu_ms);
+    float  next;
+    if (r->scale_gpu_ms > budget)            next = fmaxf(ideal, s - 0.25f);  /* 下げるのは速く */
+    else if (r->scale_gpu_ms < budget * 0.7) next = fminf(ideal, s + 0.05f);  /* 上げるのは少しずつ */
+    else return;
+    next = clampf(floorf(next * SCALE_STEP + 0.5f) / SCALE_STEP, r->scale_min, r->scale_max);
+    if (next == s) return;
+    r->render_scale   = next;
+    r->scale_gpu_ms   = 0.0;  /* 古い倍率の計測を捨てて測り直す */
+    r->scale_cooldown = SCALE_COOLDOWN;
+}
+
+/* ── フレーム ───────────────────────────────────────────*/
+void eng_scale_frame_begin(ENG_Renderer* r) {
+    eng_scale_resolve(r);  /* 前のフレームを閉じ忘れていても描画先を戻す */
+    scale_poll(r);
+
+    if (r->render_scale < 0.999f) {
+        int w = (int)floorf((float)r->win_w * r->render_scale + 0.5f);
+        int h = (int)floorf((float)r->win_h * r->render_scale + 0.5f);
+        if (w < 1) w = 1;
+        if (h < 1) h = 1;
+        if (scene_ensure(r, w, h)) {
+            glBindFramebuffer(GL_FRAMEBUFFER, r->scene_fbo);
+            r->scene_w      = w;
+            r->scene_h      = h;
+            r->target_scale = r->render_scale;
+            r->scene_active = true;
+            apply_target(r);
+        }
+    } else if (r->scene_fbo && r->scale_target_fps <= 0.0f) {
+        scene_release(r);  /* 固定倍率 1 に戻したら VRAM を返す */
+    }
+
+    if (r->scale_target_fps > 0.0f) {
+        int i = r->scale_query_next;
+        if (!r->scale_queries[0]) glGenQueries(ENG_SCALE_QUERIES, r->scale_queries);
+        if (!r->scale_query_busy[i]) {  /* 結果待ちが詰まっていればこのフレームは測らない */
+            glBeginQuery(GL_TIME_ELAPSED, r->scale_queries[i]);
+            r->scale_query_open = true;
+        }
+    }
+}
+
+void eng_scale_resolve(ENG_Renderer* r) {
+    if (!r->scene_active && !r->scale_query_open) return;
+    eng_batch_flush(r);
+    if (r->scale_query_open) {  /* 拡大と UI は倍率に関係ないので計測に含めない */
+        glEndQuery(GL_TIME_ELAPSED);
+        r->scale_query_busy[r->scale_query_next] = true;
+        r->scale_query_next = (r->scale_query_next + 1) % ENG_SCALE_QUERIES;
+        r->scale_query_open = false;
+    }
+    if (!r->scene_active) return;
+
+    /* 転送はシザーの影響を受けるので切っておく */
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, r->scene_fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, r->scene_w, r->scene_h, 0, 0, r->win_w, r->win_h,
+                      GL_COLOR_BUFFER_BIT, r->scale_nearest ? GL_NEAREST : GL_LINEAR);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (r->clip_active) glEnable(GL_SCISSOR_TEST);
+
+    r->scene_active = false;
+    r->target_scale = 1.0f;
+    apply_target(r);
+}
+
+void eng_begin_ui(ENG_Renderer* r) {
+    if (!r) return;
+    if (r->vp_recording) eng_viewport_end(r);
+    eng_scale_resolve(r);
+}
+
+/* ── 終了処理 (eng_destroy から) ───────────────────────*/
+void eng_scale_shutdown(ENG_Renderer* r) {
+    if (r->scale_query_open) glEndQuery(GL_TIME_ELAPSED);
+    if (r->scale_queries[0]) glDeleteQueries(ENG_SCALE_QUERIES, r->scale_queries);
+    for (int i = 0; i < ENG_SCALE_QUERIES; ++i) {
+        r->scale_queries[i]    = 0;
+        r->scale_query_busy[i] = false;
+    }
+    r->scale_query_open = false;
+    r->scene_active     = false;
+    r->target_scale     = 1.0f;
+    scene_release(r);
+}
@@ -12,25 +12,38 @@ static const char* VERT_SRC =
     "layout(location=0) in vec2 a_pos;\n"
     "layout(location=1) in vec2 a_uv;\n"
     "layout(location=2) in vec4 a_color;\n"
+    "layout(location=3) in float a_pal;\n"
     "out vec2  v_uv;\n"
     "out vec4  v_color;\n"
+    "flat out int v_pal;\n"
     "uniform mat4 u_proj;\n"
     "void main() {\n"
     "    gl_Position = u_proj * vec4(a_pos, 0.0, 1.0);\n"
     "    v_uv    = a_uv;\n"
     "    v_color = a_color;\n"
+    "    v_pal   = int(a_pal + 0.5);\n"
     "}\n";
 
 static const char* FRAG_SRC =
     "#version 330 core\n"
     "in vec2  v_uv;\n"
     "in vec4  v_color;\n"
+    "flat in int v_pal;\n"
     "uniform sampler2D u_tex;\n"
-    "uniform int u_use_tex;\n"
+    "uniform sampler2D u_pal;\n"
+    "uniform int u_mode;\n"   /* ENG_DRAW_* */
     "out vec4 frag;\n"
     "void main() {\n"
-    "    if (u_use_tex != 0) {\n"
+    "    if (u_mode == 2) {\n"
+    "        int idx = int(texture(u_tex, v_uv).r * 255.0 + 0.5);\n"
+    "        frag = texelFetch(u_pal, ivec2(idx, v_pal), 0) * v_color;\n"
+    "    } else if (u_mode == 1) {\n"
     "        frag = texture(u_tex, v_uv) * v_color;\n"
+    "    } else if (u_mode == 3) {\n"
+    /* 画面上の 1px 分の距離変化で輪郭をぼかす (拡大・縮小・回転で幅が自動で決まる) */
+    "        float d  = texture(u_tex, v_uv).r;\n"
+    "        float aa = max(fwidth(d) * 0.75, 1.0 / 255.0);\n"
+    "        frag = v_color * smoothstep(0.5 - aa, 0.5 + aa, d);\n"
     "    } else {\n"
     "        frag = v_color;\n"
     "    }\n"
@@ -96,18 +109,44 @@ bool eng_shader_init(ENG_Batch* b) {
     if (!b->prog) return false;
 
     b->loc_proj    = glGetUniformLocation(b->prog, "u_proj");
-    b->loc_use_tex = glGetUniformLocation(b->prog, "u_use_tex");
+    b->loc_mode    = glGetUniformLocation(b->prog, "u_mode");
     b->loc_tex     = glGetUniformLocation(b->prog, "u_tex");
+    b->loc_pal     = glGetUniformLocation(b->prog, "u_pal");
 
     return true;
 }
 
+/* ── 頂点属性レイアウト ─────────────────────────────────*/
+/* バインド中の VAO と ARRAY_BUFFER に対して設定する (ビューポート再生用 VAO と共用) */
+void eng_batch_layout(void) {
+    /* location 0: position (xy) */
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+        sizeof(ENG_Vertex),
+        (void*)offsetof(ENG_Vertex, x));
+    glEnableVertexAttribArray(0);
+    /* location 1: uv */
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+        sizeof(ENG_Vertex),
+        (void*)offsetof(ENG_Vertex, u));
+    glEnableVertexAttribArray(1);
+    /* location 2: color (rgba) */
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE,
+        sizeof(ENG_Vertex),
+        (void*)offsetof(ENG_Vertex, r));
+    glEnableVertexAttribArray(2);
+    /* location 3: パレット行 */
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE,
+        sizeof(ENG_Vertex),
+        (void*)offsetof(ENG_Vertex, pal));
+    glEnableVertexAttribArray(3);
+}
+
 /* ── バッチ VAO/VBO/IBO 初期化 ──────────────────────────*/
 void eng_batch_init(ENG_Batch* b, GLuint prog) {
     (void)prog;
     b->quad_count  = 0;
     b->current_tex = 0;
-    b->use_tex     = false;
+    b->mode        = ENG_DRAW_COLOR;
 
     /* VAO */
     glGenVertexArrays(1, &b->vao);
@@ -120,22 +159,7 @@ void eng_batch_init(ENG_Batch* b, GLuint prog) {
                  ENG_MAX_BATCH * 4 * sizeof(ENG_Vertex),
                  NULL, GL_DYNAMIC_DRAW);
 
-    /* 属性レイアウト */
-    /* location 0: position (xy) */
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
-        sizeof(ENG_Vertex),
-        (void*)offsetof(ENG_Vertex, x));
-    glEnableVertexAttribArray(0);
-    /* location 1: uv */
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
-        sizeof(ENG_Vertex),
-        (void*)offsetof(ENG_Vertex, u));
-    glEnableVertexAttribArray(1);
-    /* location 2: color (rgba) */
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE,
-        sizeof(ENG_Vertex),
-        (void*)offsetof(ENG_Vertex, r));
-    glEnableVertexAttribArray(2);
+    eng_batch_layout();
 
     /* IBO (静的: 事前計算済みインデックス) */
     uint32_t* indices = (uint32_t*)malloc(ENG_MAX_BATCH * 6 * sizeof(uint32_t));
@@ -154,13 +178,27 @@ void eng_batch_init(ENG_Batch* b, GLuint prog) {
 void eng_batch_flush(ENG_Renderer* r) {
     ENG_Batch* b = &r->batch;
     if (b->quad_count == 0) return;
+    if (r->vp_recording) {  /* ビューポートごとの再生は eng_viewport_end で */
+        eng_viewport_record(r);
+        return;
+    }
 
+    eng_glyph_upload(r);  /* このバッチが使うグリフを含め、溜まった分を 1 回で転送 */
     glUseProgram(b->prog);
-    glUniform1i(b->loc_use_tex, b->use_tex ? 1 : 0);
-    if (b->use_tex) {
+    glUniform1i(b->loc_mode, b->mode);
+    if (b->mode == ENG_DRAW_INDEXED) {
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, r->pal_tex);
+        glUniform1i(b->loc_pal, 1);
+    }
+    if (b->mode != ENG_DRAW_COLOR) {
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, b->current_tex);
         glUniform1i(b->loc_tex, 0);
+        if (b->bound_sampler != b->current_sampler) {
+            glBindSampler(0, b->current_sampler);
+            b->bound_sampler = b->current_sampler;
+        }
     }
 
     glBindVertexArray(b->vao);
@@ -171,8 +209,32 @@ void eng_batch_flush(ENG_Renderer* r) {
     glDrawElements(GL_TRIANGLES,
                    b->quad_count * 6,
                    GL_UNSIGNED_INT, NULL);
-    b->quad_count  = 0;
-    b->current_tex = 0;
+    b->quad_count      = 0;
+    b->current_tex     = 0;
+    b->current_sampler = 0;
+}
+
+/* ── 配置済みクワッドの複写 (テキストレイアウト) ───────*/
+/* 頂点は色・位置まで確定済み。サンプラーはテクスチャ自身のものを使う */
+void eng_batch_push_verts(ENG_Renderer* r, GLuint tex, int mode,
+                          const ENG_Vertex* v, int quads) {
+    ENG_Batch* b = &r->batch;
+    if (b->quad_count > 0 &&
+        (b->current_tex != tex || b->current_sampler != 0 || b->mode != mode)) {
+        eng_batch_flush(r);
+    }
+    while (quads > 0) {
+        if (b->quad_count >= ENG_MAX_BATCH) eng_batch_flush(r);
+        b->current_tex     = tex;
+        b->current_sampler = 0;
+        b->mode            = mode;
+        int n = ENG_MAX_BATCH - b->quad_count;
+        if (n > quads) n = quads;
+        memcpy(&b->verts[b->quad_count * 4], v, (size_t)n * 4 * sizeof(ENG_Vertex));
+        b->quad_count += n;
+        v     += n * 4;
+        quads -= n;
+    }
 }
 
 /* ── クワッド追加 ───────────────────────────────────────*/
@@ -181,21 +243,32 @@ void eng_batch_push_quad(ENG_Renderer* r,
     float u0, float v0, float u1, float v1,
     float rot, float ox, float oy,
     float cr, float cg, float cb, float ca,
-    GLuint tex, bool use_tex)
+    const ENG_TexRef* t)
 {
     ENG_Batch* b = &r->batch;
+    GLuint tex     = t ? t->gl_id   : 0;
+    GLuint sampler = t ? t->sampler : 0;
+    int    mode    = t ? t->mode    : ENG_DRAW_COLOR;
 
-    /* テクスチャ切り替え時またはバッチ満杯時にフラッシュ */
+    /* テクスチャ / サンプラー / モード切り替え時またはバッチ満杯時にフラッシュ。
+     * パレット行は頂点に載せるので、色違いは同じバッチに入る */
     if (b->quad_count > 0 &&
-        (b->current_tex != tex || b->use_tex != use_tex)) {
+        (b->current_tex != tex || b->current_sampler != sampler ||
+         b->mode != mode)) {
         eng_batch_flush(r);
     }
     if (b->quad_count >= ENG_MAX_BATCH) {
         eng_batch_flush(r);
     }
 
-    b->current_tex = tex;
-    b->use_tex     = use_tex;
+    b->current_tex     = tex;
+    b->current_sampler = sampler;
+    b->mode            = mode;
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
+    float pal = 0.0f;
+    if (mode == ENG_DRAW_INDEXED) {
+        pal = (float)(r->palette ? (int)r->palette - 1 : t->pal_row);
+    }
 
     /* 4頂点の座標を計算 (回転あり) */
     float half_w = w * 0.5f;
@@ -229,6 +302,7 @@ void eng_batch_push_quad(ENG_Renderer* r,
         b->verts[base+i].g = cg;
         b->verts[base+i].b = cb;
         b->verts[base+i].a = ca;
+        b->verts[base+i].pal = pal;
     }
     (void)half_w; (void)half_h;
     b->quad_count++;
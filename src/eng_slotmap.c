@@ -0,0 +1,102 @@
+/**
+ * src/eng_slotmap.c — 世代付きハンドル表 (テクスチャ / フォント用)
+ *
+ * ID = (世代 << ENG_SLOT_INDEX_BITS) | (インデックス + 1)
+ *   - 確保/解放は空きリストで O(1)、上限なしに伸長する
+ *   - 解放時に世代を進めるので、解放済み ID は再利用後も一致しない
+ *   - 要素は固定長チャンクに置くため、伸長してもポインタは動かない
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CHUNK_SHIFT 8
+#define CHUNK_SIZE  (1 << CHUNK_SHIFT)
+
+static inline uint32_t id_index(uint32_t id) { return (id & ENG_SLOT_INDEX_MASK) - 1; }
+
+void eng_slots_init(ENG_SlotMap* m, size_t elem_size) {
+    memset(m, 0, sizeof(*m));
+    m->elem_size = elem_size;
+    m->free_head = -1;
+}
+
+static bool grow(ENG_SlotMap* m) {
+    int cap = m->cap + CHUNK_SIZE;
+    if ((uint32_t)cap >= ENG_SLOT_INDEX_MASK) return false;
+    int nchunks = cap >> CHUNK_SHIFT;
+
+    void**    chunks = (void**)realloc(m->chunks, (size_t)nchunks * sizeof(void*));
+    if (!chunks) return false;
+    m->chunks = chunks;
+    uint32_t* ids  = (uint32_t*)realloc(m->ids,  (size_t)cap * sizeof(uint32_t));
+    if (!ids) return false;
+    m->ids = ids;
+    uint16_t* gens = (uint16_t*)realloc(m->gens, (size_t)cap * sizeof(uint16_t));
+    if (!gens) return false;
+    m->gens = gens;
+    int32_t*  next = (int32_t*)realloc(m->next_free, (size_t)cap * sizeof(int32_t));
+    if (!next) return false;
+    m->next_free = next;
+
+    void* chunk = calloc(CHUNK_SIZE, m->elem_size);
+    if (!chunk) return false;
+    m->chunks[nchunks - 1] = chunk;
+
+    /* 新しいインデックスを空きリストへ (小さい番号から使う) */
+    for (int i = cap - 1; i >= m->cap; --i) {
+        m->ids[i]       = 0;
+        m->gens[i]      = 1;
+        m->next_free[i] = m->free_head;
+        m->free_head    = i;
+    }
+    m->cap = cap;
+    return true;
+}
+
+uint32_t eng_slots_alloc(ENG_SlotMap* m) {
+    if (m->free_head < 0 && !grow(m)) return 0;
+    int idx = m->free_head;
+    m->free_head = m->next_free[idx];
+
+    uint32_t id = ((uint32_t)m->gens[idx] << ENG_SLOT_INDEX_BITS) | (uint32_t)(idx + 1);
+    m->ids[idx] = id;
+    memset(eng_slots_at(m, idx), 0, m->elem_size);
+    m->count++;
+    return id;
+}
+
+void* eng_slots_get(const ENG_SlotMap* m, uint32_t id) {
+    uint32_t idx = id_index(id);
+    if (id == 0 || idx >= (uint32_t)m->cap || m->ids[idx] != id) return NULL;
+    return eng_slots_at(m, (int)idx);
+}
+
+void eng_slots_free(ENG_SlotMap* m, uint32_t id) {
+    uint32_t idx = id_index(id);
+    if (id == 0 || idx >= (uint32_t)m->cap || m->ids[idx] != id) return;
+    m->ids[idx]  = 0;
+    /* 世代は 1〜ENG_SLOT_GEN_MAX を循環 (ID が INT32 範囲に収まるように) */
+    m->gens[idx] = (uint16_t)(m->gens[idx] % ENG_SLOT_GEN_MAX + 1);
+    m->next_free[idx] = m->free_head;
+    m->free_head = (int32_t)idx;
+    m->count--;
+}
+
+void* eng_slots_at(const ENG_SlotMap* m, int idx) {
+    return (char*)m->chunks[idx >> CHUNK_SHIFT] +
+           (size_t)(idx & (CHUNK_SIZE - 1)) * m->elem_size;
+}
+
+uint32_t eng_slots_id_at(const ENG_SlotMap* m, int idx) {
+    return m->ids[idx];
+}
+
+void eng_slots_destroy(ENG_SlotMap* m) {
+    for (int i = 0; i < (m->cap >> CHUNK_SHIFT); ++i) free(m->chunks[i]);
+    free(m->chunks);
+    free(m->ids);
+    free(m->gens);
+    free(m->next_free);
+    eng_slots_init(m, m->elem_size);
+}
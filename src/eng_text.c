@@ -0,0 +1,487 @@
+/**
+ * src/eng_text.c — 行分割 (禁則処理) とテキストレイアウト (配置済みグリフのキャッシュ)
+ *
+ * 行分割は語単位 (空白の後、または CJK 文字の間) で折り返し、日本語の禁則
+ * (行頭の句読点・閉じ括弧、行末の開き括弧) を避ける。eng_draw_text_wrap と
+ * eng_text_measure は同じ分割を共有し、直前と同じ文字列なら分割し直さない。
+ *
+ * レイアウトは文字列を 1 回だけ行分割・配置して頂点配列として持ち、描画はバッチへの
+ * memcpy で済ませる。位置と色が前回と同じなら頂点の書き直しもしない。
+ * 作り直すのは文字列が変わったとき (eng_text_layout_set_text) と、
+ * 使っているグリフキャッシュのページが追い出されたときだけ。
+ */
+#include "eng_internal.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+/* 同じテクスチャ・モードが続く範囲 (バッチ 1 回分) */
+typedef struct {
+    GLuint tex;
+    int    mode;
+    int    first, count;  /* クワッド単位 */
+} ENG_TextRun;
+
+typedef struct {
+    ENG_FontID    font;
+    char*         text;
+    float         max_w;
+    ENG_TextAlign align;
+    float         w, h;          /* 計測した外接サイズ */
+    int           lines;
+
+    ENG_Vertex*   local;         /* 原点 (1 行目のベースライン左端) 基準・色なし */
+    ENG_Vertex*   verts;         /* 位置と色を焼き込んだもの (バッチへそのまま複写) */
+    int           quad_count, quad_cap;
+    ENG_TextRun*  runs;
+    int           run_count, run_cap;
+
+    uint32_t      page_epoch[ENG_GLYPH_MAX_PAGES];
+    uint8_t       page_mask;     /* 使っているグリフキャッシュのページ */
+
+    bool          incomplete;    /* 非同期ラスタライズ待ちで描けなかったグリフがある */
+    uint32_t      placed_at;     /* その時点の r->glyph_placed */
+
+    bool          baked;         /* verts が下の値で焼き込み済み */
+    float         bx, by, bcolor[4];
+} ENG_TextLayout;
+
+static inline ENG_TextLayout* layout_get(ENG_Renderer* r, ENG_TextID id) {
+    return r ? (ENG_TextLayout*)eng_slots_get(&r->texts, id) : NULL;
+}
+
+/* ── 行分割 (禁則処理) ─────────────────────────────────*/
+/* 行頭に置かない文字 (閉じ括弧・句読点・小書き仮名・長音など) */
+static bool no_line_start(uint32_t cp) {
+    switch (cp) {
+    case '!': case ')': case ',': case '.': case ':': case ';': case '?': case ']': case '}':
+    case '%':
+    case 0x2019: case 0x201D: case 0x2010: case 0x2013: case 0x2025: case 0x2026:
+    case 0x3001: case 0x3002: case 0x3005: case 0x3009: case 0x300B: case 0x300D:
+    case 0x300F: case 0x3011: case 0x3015: case 0x3017: case 0x3019: case 0x301C:
+    case 0x301F: case 0x303B: case 0x309D: case 0x309E: case 0x30A0: case 0x30FB:
+    case 0x30FC: case 0x30FD: case 0x30FE:
+    case 0x3041: case 0x3043: case 0x3045: case 0x3047: case 0x3049: case 0x3063:
+    case 0x3083: case 0x3085: case 0x3087: case 0x308E: case 0x3095: case 0x3096:
+    case 0x30A1: case 0x30A3: case 0x30A5: case 0x30A7: case 0x30A9: case 0x30C3:
+    case 0x30E3: case 0x30E5: case 0x30E7: case 0x30EE: case 0x30F5: case 0x30F6:
+    case 0xFF01: case 0xFF05: case 0xFF09: case 0xFF0C: case 0xFF0E: case 0xFF1A:
+    case 0xFF1B: case 0xFF1F: case 0xFF3D: case 0xFF5D: case 0xFF5E: case 0xFF61:
+    case 0xFF63: case 0xFF64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* 行末に置かない文字 (開き括弧・通貨記号) */
+static bool no_line_end(uint32_t cp) {
+    switch (cp) {
+    case '(': case '[': case '{': case '$':
+    case 0x2018: case 0x201C: case 0x00A5:
+    case 0x3008: case 0x300A: case 0x300C: case 0x300E: case 0x3010: case 0x3014:
+    case 0x3016: case 0x3018: case 0x301D:
+    case 0xFF04: case 0xFF08: case 0xFF3B: case 0xFF5B: case 0xFF62: case 0xFFE5:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* どの文字の間でも改行してよい文字 (漢字・仮名・全角記号・ハングル) */
+static bool breaks_anywhere(uint32_t cp) {
+    return (cp >= 0x2E80 && cp <= 0x9FFF) || (cp >= 0xAC00 && cp <= 0xD7AF) ||
+           (cp >= 0xF900 && cp <= 0xFAFF) || (cp >= 0xFF00 && cp <= 0xFFEF) ||
+           (cp >= 0x20000 && cp <= 0x3FFFF);
+}
+
+static inline bool is_space(uint32_t cp) { return cp == ' ' || cp == '\t'; }
+
+/* c[i-1] と c[i] の間で改行してよいか */
+static bool can_break_before(const ENG_TextChar* c, int i) {
+    uint32_t prev = c[i - 1].cp, cur = c[i].cp;
+    if (is_space(cur)) return false;            /* 空白は前の語に付けて行末へ */
+    if (no_line_start(cur) || no_line_end(prev)) return false;
+    if (is_space(prev)) return true;            /* 語の区切り */
+    return breaks_anywhere(prev) || breaks_anywhere(cur);
+}
+
+/* 貪欲法で行に分ける。max_w <= 0 なら改行文字でのみ分ける。
+ * 幅を超えたら直前の改行可能位置で折り返し、語が 1 行に収まらないときだけ文字単位で切る。
+ * 行頭禁則の文字は前の行の末尾にぶら下げ、行末禁則の文字は次の行へ追い出す */
+static int break_lines(const ENG_TextChar* c, int n, float max_w, ENG_TextLine* lines) {
+    int nl = 0, s = 0;
+    for (;;) {
+        int   i = s, brk = -1, e, next;
+        float pen = 0.0f;
+        for (;;) {
+            if (i >= n)         { e = n; next = n + 1; break; }
+            if (c[i].cp == '\n') { e = i; next = i + 1; break; }
+            if (i > s && can_break_before(c, i)) brk = i;
+            if (max_w > 0.0f && i > s && pen + c[i].adv > max_w &&
+                !is_space(c[i].cp) && !no_line_start(c[i].cp)) {
+                if (brk > s) {
+                    e = brk;
+                } else {
+                    e = i;
+                    if (e - 1 > s && no_line_end(c[e - 1].cp)) e--;
+                }
+                next = e;
+                while (next < n && is_space(c[next].cp)) next++;  /* 折り返し位置の空白は捨てる */
+                break;
+            }
+            pen += c[i].adv;
+            i++;
+        }
+        int t = e;
+        while (t > s && is_space(c[t - 1].cp)) t--;
+        float w = 0.0f;
+        for (int j = s; j < t; ++j) w += c[j].adv;
+        lines[nl++] = (ENG_TextLine){ s, e, w };
+        if (next > n) return nl;
+        s = next;
+    }
+}
+
+/* text を文字に展開して行分割する (b の配列は使い回す) */
+static bool break_text(ENG_FontEntry* fe, const char* text, float max_w, ENG_TextBreak* b) {
+    size_t len = strlen(text);
+    if ((size_t)b->char_cap < len + 1) {
+        ENG_TextChar* c = (ENG_TextChar*)realloc(b->chars, (len + 1) * sizeof(ENG_TextChar));
+        if (!c) return false;
+        b->chars    = c;
+        b->char_cap = (int)len + 1;
+    }
+    if ((size_t)b->line_cap < len + 1) {  /* 行数 ≤ 文字数 + 1 */
+        ENG_TextLine* l = (ENG_TextLine*)realloc(b->lines, (len + 1) * sizeof(ENG_TextLine));
+        if (!l) return false;
+        b->lines    = l;
+        b->line_cap = (int)len + 1;
+    }
+    float k = eng_font_k(fe);
+    int   n = 0;
+    for (const char* p = text; *p; ) {
+        uint32_t cp = eng_utf8_next(&p);
+        b->chars[n].cp  = cp;
+        b->chars[n].adv = cp == '\n' ? 0.0f : eng_font_advance(fe, cp, k);
+        n++;
+    }
+    b->char_count = n;
+    b->line_count = break_lines(b->chars, n, max_w, b->lines);
+    b->w = 0.0f;
+    for (int i = 0; i < b->line_count; ++i) if (b->lines[i].w > b->w) b->w = b->lines[i].w;
+    return true;
+}
+
+static void break_free(ENG_TextBreak* b) {
+    free(b->text);
+    free(b->chars);
+    free(b->lines);
+    memset(b, 0, sizeof(*b));
+}
+
+/* 折り返し描画/計測用: 直前と同じ (フォント, 文字列, 幅) なら前回の分割を返す */
+static const ENG_TextBreak* wrap_get(ENG_Renderer* r, ENG_FontID fid, ENG_FontEntry* fe,
+                                     const char* text, float max_w) {
+    ENG_TextBreak* b = &r->wrap;
+    if (b->text && b->font == fid && b->max_w == max_w && strcmp(b->text, text) == 0) return b;
+
+    size_t len = strlen(text);
+    if (b->text_cap < len + 1) {
+        char* t = (char*)realloc(b->text, len + 1);
+        if (!t) return NULL;
+        b->text     = t;
+        b->text_cap = len + 1;
+    }
+    if (!break_text(fe, text, max_w, b)) {
+        b->text[0] = '\0';
+        b->font    = 0;
+        return NULL;
+    }
+    memcpy(b->text, text, len + 1);
+    b->font  = fid;
+    b->max_w = max_w;
+    return b;
+}
+
+/* ── 構築 ───────────────────────────────────────────────*/
+typedef struct {
+    ENG_GlyphQuad q;
+    int           line;
+    int           order;   /* 並べ替えを安定にするための元の順番 */
+} ENG_PlacedGlyph;
+
+static int cmp_placed(const void* a, const void* b) {
+    const ENG_PlacedGlyph* x = (const ENG_PlacedGlyph*)a;
+    const ENG_PlacedGlyph* y = (const ENG_PlacedGlyph*)b;
+    if (x->q.tex  != y->q.tex)  return x->q.tex  < y->q.tex  ? -1 : 1;
+    if (x->q.mode != y->q.mode) return x->q.mode < y->q.mode ? -1 : 1;
+    return x->order - y->order;
+}
+
+static bool reserve(ENG_TextLayout* t, int quads) {
+    if (quads <= t->quad_cap) return true;
+    int cap = t->quad_cap ? t->quad_cap : 16;
+    while (cap < quads) cap *= 2;
+    ENG_Vertex*  l  = (ENG_Vertex*)realloc(t->local, (size_t)cap * 4 * sizeof(ENG_Vertex));
+    if (!l) return false;
+    t->local = l;
+    ENG_Vertex*  v  = (ENG_Vertex*)realloc(t->verts, (size_t)cap * 4 * sizeof(ENG_Vertex));
+    if (!v) return false;
+    t->verts = v;
+    ENG_TextRun* rn = (ENG_TextRun*)realloc(t->runs, (size_t)cap * sizeof(ENG_TextRun));
+    if (!rn) return false;
+    t->runs     = rn;
+    t->quad_cap = cap;
+    return true;
+}
+
+/* 行分割して各グリフのクワッドを原点基準で求め、テクスチャごとにまとめる。
+ * 途中のグリフ確保で使用中のページが追い出されたら、そのページのクワッドを捨てて false */
+static bool build_once(ENG_Renderer* r, ENG_TextLayout* t) {
+    t->quad_count = 0;
+    t->run_count  = 0;
+    t->page_mask  = 0;
+    t->baked      = false;
+    t->w = t->h   = 0.0f;
+    t->lines      = 0;
+    ENG_FontEntry* fe = eng_font_get(r, t->font);
+    if (!fe || !t->text) return true;
+
+    ENG_TextBreak br;
+    memset(&br, 0, sizeof(br));
+    if (!break_text(fe, t->text, t->max_w, &br)) { break_free(&br); return true; }
+    ENG_PlacedGlyph* pg = (ENG_PlacedGlyph*)malloc(((size_t)br.char_count + 1) * sizeof(ENG_PlacedGlyph));
+    if (!pg) { break_free(&br); return true; }
+
+    float    k      = eng_font_k(fe);
+    float    line_h = fe->size * 1.2f;  /* eng_draw_text_wrap と同じ行間 */
+    int      n      = 0;
+    uint32_t misses = r->glyph_misses;
+    for (int line = 0; line < br.line_count; ++line) {
+        const ENG_TextLine* ln = &br.lines[line];
+        float pen = 0.0f;
+        for (int i = ln->start; i < ln->end; ++i) {
+            if (eng_font_quad(r, fe, br.chars[i].cp, pen, (float)line * line_h, k, &pg[n].q)) {
+                pg[n].line  = line;
+                pg[n].order = n;
+                int page = pg[n].q.page;
+                if (page >= 0 && !(t->page_mask & (1u << page))) {  /* 初めて使った時点の epoch */
+                    t->page_mask |= (uint8_t)(1u << page);
+                    t->page_epoch[page] = r->glyphs.pages[page].epoch;
+                }
+                n++;
+            }
+            pen += br.chars[i].adv;
+        }
+    }
+
+    /* 後のグリフの確保で追い出されたページの UV は古いので使わない */
+    int kept = 0;
+    for (int i = 0; i < n; ++i) {
+        int page = pg[i].q.page;
+        if (page >= 0 && r->glyphs.pages[page].epoch != t->page_epoch[page]) continue;
+        pg[kept++] = pg[i];
+    }
+    bool fresh = kept == n;
+    n = kept;
+
+    t->incomplete = r->glyph_misses != misses;
+    t->placed_at  = r->glyph_placed;
+
+    float box_w = br.w;
+    t->w     = br.w;
+    t->h     = (float)br.line_count * line_h;
+    t->lines = br.line_count;
+    if (t->max_w > 0.0f) box_w = t->max_w;
+
+    qsort(pg, (size_t)n, sizeof(ENG_PlacedGlyph), cmp_placed);
+    if (!reserve(t, n)) n = 0;
+    for (int i = 0; i < n; ++i) {
+        const ENG_GlyphQuad* q = &pg[i].q;
+        float dx = 0.0f;
+        float lw = br.lines[pg[i].line].w;
+        if (t->align == ENG_ALIGN_CENTER)     dx = (box_w - lw) * 0.5f;
+        else if (t->align == ENG_ALIGN_RIGHT) dx = box_w - lw;
+        float x0 = q->x + dx, y0 = q->y, x1 = x0 + q->w, y1 = y0 + q->h;
+        ENG_Vertex* v = &t->local[i * 4];
+        v[0] = (ENG_Vertex){ x0, y0, q->u0, q->v0, 0, 0, 0, 0, 0 };
+        v[1] = (ENG_Vertex){ x1, y0, q->u1, q->v0, 0, 0, 0, 0, 0 };
+        v[2] = (ENG_Vertex){ x1, y1, q->u1, q->v1, 0, 0, 0, 0, 0 };
+        v[3] = (ENG_Vertex){ x0, y1, q->u0, q->v1, 0, 0, 0, 0, 0 };
+
+        ENG_TextRun* run = t->run_count ? &t->runs[t->run_count - 1] : NULL;
+        if (run && run->tex == q->tex && run->mode == q->mode) {
+            run->count++;
+        } else {
+            t->runs[t->run_count++] = (ENG_TextRun){ q->tex, q->mode, i, 1 };
+        }
+    }
+    t->quad_count = n;
+    free(pg);
+    break_free(&br);
+    return fresh;
+}
+
+/* 追い出しが起きたら作り直す。文字数がキャッシュに収まらなければ諦め、
+ * page_epoch が古いままなので次の描画でまた作り直す (古い UV では描かない) */
+static void build(ENG_Renderer* r, ENG_TextLayout* t) {
+    for (int attempt = 0; attempt < 3 && !build_once(r, t); ++attempt) {}
+}
+
+/* 使っているページがどれも追い出されておらず、待っていたグリフも届いていなければ有効 */
+static bool still_valid(const ENG_Renderer* r, const ENG_TextLayout* t) {
+    if (t->incomplete && t->placed_at != r->glyph_placed) return false;
+    for (int p = 0; p < ENG_GLYPH_MAX_PAGES; ++p) {
+        if ((t->page_mask & (1u << p)) && r->glyphs.pages[p].epoch != t->page_epoch[p]) return false;
+    }
+    return true;
+}
+
+static bool set_text(ENG_TextLayout* t, const char* text) {
+    size_t len = strlen(text);
+    char*  dup = (char*)malloc(len + 1);
+    if (!dup) return false;
+    memcpy(dup, text, len + 1);
+    free(t->text);
+    t->text = dup;
+    return true;
+}
+
+/* ── 公開 API ───────────────────────────────────────────*/
+ENG_TextID eng_text_layout_create(ENG_Renderer* r, ENG_FontID font, const char* utf8,
+                                  float max_w, ENG_TextAlign align) {
+    if (!r || !utf8 || !eng_font_get(r, font)) return 0;
+    ENG_TextID id = eng_slots_alloc(&r->texts);
+    if (!id) {
+        fprintf(stderr, "[eng_render] テキストレイアウトを確保できません\n");
+        return 0;
+    }
+    ENG_TextLayout* t = layout_get(r, id);
+    t->font  = font;
+    t->max_w = max_w;
+    t->align = (unsigned)align <= ENG_ALIGN_RIGHT ? align : ENG_ALIGN_LEFT;
+    if (!set_text(t, utf8)) {
+        eng_slots_free(&r->texts, id);
+        return 0;
+    }
+    build(r, t);
+    return id;
+}
+
+bool eng_text_layout_set_text(ENG_Renderer* r, ENG_TextID id, const char* utf8) {
+    ENG_TextLayout* t = layout_get(r, id);
+    if (!t || !utf8) return false;
+    if (t->text && strcmp(t->text, utf8) == 0) return true;  /* 変化なし */
+    if (!set_text(t, utf8)) return false;
+    build(r, t);
+    return true;
+}
+
+void eng_text_layout_draw(ENG_Renderer* r, ENG_TextID id, float x, float y,
+                          float cr, float cg, float cb, float ca) {
+    ENG_TextLayout* t = layout_get(r, id);
+    if (!t || !eng_font_get(r, t->font)) return;
+    if (!still_valid(r, t)) build(r, t);
+    if (t->quad_count == 0) return;
+
+    for (int p = 0; p < ENG_GLYPH_MAX_PAGES; ++p) {
+        if (t->page_mask & (1u << p)) r->glyphs.pages[p].last_used = r->tex_frame;
+    }
+
+    /* 位置か色が変わったときだけ焼き直す (静的なラベルは複写のみ) */
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
+    if (!t->baked || t->bx != x || t->by != y || t->bcolor[0] != cr ||
+        t->bcolor[1] != cg || t->bcolor[2] != cb || t->bcolor[3] != ca) {
+        int nv = t->quad_count * 4;
+        for (int i = 0; i < nv; ++i) {
+            ENG_Vertex v = t->local[i];
+            v.x += x; v.y += y;
+            v.r = cr; v.g = cg; v.b = cb; v.a = ca;
+            t->verts[i] = v;
+        }
+        t->baked = true;
+        t->bx = x; t->by = y;
+        t->bcolor[0] = cr; t->bcolor[1] = cg; t->bcolor[2] = cb; t->bcolor[3] = ca;
+    }
+
+    for (int i = 0; i < t->run_count; ++i) {
+        const ENG_TextRun* run = &t->runs[i];
+        eng_batch_push_verts(r, run->tex, run->mode, &t->verts[run->first * 4], run->count);
+    }
+}
+
+void eng_text_layout_size(ENG_Renderer* r, ENG_TextID id, float* w, float* h) {
+    ENG_TextLayout* t = layout_get(r, id);
+    if (w) *w = t ? t->w : 0.0f;
+    if (h) *h = t ? t->h : 0.0f;
+}
+
+/* ── 折り返し描画 / 計測 ───────────────────────────────*/
+/* 分割結果からグリフをそのままバッチへ積む (文字ごとのスロット検証・色計算はしない) */
+void eng_draw_text_wrap(ENG_Renderer* r, ENG_FontID fid, const char* text,
+                        float x, float y, float max_w,
+                        float cr, float cg, float cb, float ca) {
+    ENG_FontEntry* fe = eng_font_get(r, fid);
+    if (!fe || !text || max_w <= 0.0f) return;
+    const ENG_TextBreak* b = wrap_get(r, fid, fe, text, max_w);
+    if (!b) return;
+
+    eng_blend_color(r, &cr, &cg, &cb, &ca);
+    float k      = eng_font_k(fe);
+    float line_h = fe->size * 1.2f;  /* 行間 = フォントサイズ * 1.2 */
+    for (int line = 0; line < b->line_count; ++line) {
+        const ENG_TextLine* ln = &b->lines[line];
+        float pen = x, base = y + (float)line * line_h;
+        for (int i = ln->start; i < ln->end; ++i) {
+            ENG_GlyphQuad q;
+            if (eng_font_quad(r, fe, b->chars[i].cp, pen, base, k, &q)) {
+                float x1 = q.x + q.w, y1 = q.y + q.h;
+                ENG_Vertex v[4] = {
+                    { q.x, q.y, q.u0, q.v0, cr, cg, cb, ca, 0 },
+                    { x1,  q.y, q.u1, q.v0, cr, cg, cb, ca, 0 },
+                    { x1,  y1,  q.u1, q.v1, cr, cg, cb, ca, 0 },
+                    { q.x, y1,  q.u0, q.v1, cr, cg, cb, ca, 0 },
+                };
+                eng_batch_push_verts(r, q.tex, q.mode, v, 1);
+            }
+            pen += b->chars[i].adv;
+        }
+    }
+}
+
+void eng_text_measure(ENG_Renderer* r, ENG_FontID fid, const char* text, float max_w,
+                      float* w, float* h) {
+    ENG_FontEntry*       fe = eng_font_get(r, fid);
+    const ENG_TextBreak* b  = fe && text ? wrap_get(r, fid, fe, text, max_w) : NULL;
+    if (w) *w = b ? b->w : 0.0f;
+    if (h) *h = b ? (float)b->line_count * fe->size * 1.2f : 0.0f;
+}
+
+static void release_layout(ENG_TextLayout* t) {
+    free(t->text);
+    free(t->local);
+    free(t->verts);
+    free(t->runs);
+}
+
+void eng_text_layout_free(ENG_Renderer* r, ENG_TextID id) {
+    ENG_TextLayout* t = layout_get(r, id);
+    if (!t) return;
+    release_layout(t);
+    eng_slots_free(&r->texts, id);
+}
+
+/* ── 初期化 / 終了処理 (eng_create / eng_destroy から) ─*/
+void eng_text_init(ENG_Renderer* r) {
+    eng_slots_init(&r->texts, sizeof(ENG_TextLayout));
+}
+
+void eng_text_shutdown(ENG_Renderer* r) {
+    for (int i = 0; i < r->texts.cap; ++i) {
+        ENG_TextLayout* t = layout_get(r, eng_slots_id_at(&r->texts, i));
+        if (t) release_layout(t);
+    }
+    eng_slots_destroy(&r->texts);
+    break_free(&r->wrap);
+}
@@ -1,11 +1,12 @@
 /**
- * src/eng_texture.c — テクスチャ読み込み (stb_image)
+ * src/eng_texture.c — テクスチャ読み込み (stb_image / DDS / KTX)
  */
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
 #include "eng_internal.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 /* ── OpenGL テクスチャ生成ヘルパー ──────────────────────*/
@@ -32,74 +33,896 @@ static GLuint upload_texture(const unsigned char* pixels,
     return tex;
 }
 
+/* GL 3.3 コアヘッダーに無い拡張形式 */
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+  #define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+  #define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+  #define GL_COMPRESSED_RGBA_BPTC_UNORM    0x8E8C
+#endif
+#ifndef GL_RGB565
+  #define GL_RGB565                        0x8D62
+#endif
+
+/* ── 非圧縮形式の GL 表現 ───────────────────────────────*/
+typedef struct {
+    GLenum ifmt, fmt, type;
+    int    bpp;  /* byte/px (= GL_UNPACK_ALIGNMENT に使える値) */
+} ENG_PixelFmt;
+
+static ENG_PixelFmt pixel_fmt(ENG_TexFormat f) {
+    switch (f) {
+        case ENG_TEXFMT_RGB565:   return (ENG_PixelFmt){ GL_RGB565, GL_RGB,  GL_UNSIGNED_SHORT_5_6_5,   2 };
+        case ENG_TEXFMT_RGBA4444: return (ENG_PixelFmt){ GL_RGBA4,  GL_RGBA, GL_UNSIGNED_SHORT_4_4_4_4, 2 };
+        case ENG_TEXFMT_INDEX8:   return (ENG_PixelFmt){ GL_R8,     GL_RED,  GL_UNSIGNED_BYTE,          1 };
+        default:                  return (ENG_PixelFmt){ GL_RGBA8,  GL_RGBA, GL_UNSIGNED_BYTE,          4 };
+    }
+}
+
+/* ── サンプラー (同じ設定のテクスチャで共有) ──────────*/
+static GLuint sampler_for(ENG_Renderer* r, ENG_TexFilter filter, ENG_TexWrap wrap, bool mips) {
+    uint8_t key = ENG_SAMPLER_KEY(filter, wrap, mips);
+    if (key == 0 || r->tex_samplers[key]) return r->tex_samplers[key];
+
+    static const GLenum wraps[3] = { GL_CLAMP_TO_EDGE, GL_REPEAT, GL_MIRRORED_REPEAT };
+    GLenum min_f, mag_f;
+    switch (filter) {
+        case ENG_FILTER_LINEAR:
+            min_f = mips ? GL_LINEAR_MIPMAP_NEAREST : GL_LINEAR;
+            mag_f = GL_LINEAR;
+            break;
+        case ENG_FILTER_TRILINEAR:
+            min_f = GL_LINEAR_MIPMAP_LINEAR;
+            mag_f = GL_LINEAR;
+            break;
+        default:
+            min_f = mips ? GL_NEAREST_MIPMAP_NEAREST : GL_NEAREST;
+            mag_f = GL_NEAREST;
+            break;
+    }
+    GLuint s;
+    glGenSamplers(1, &s);
+    glSamplerParameteri(s, GL_TEXTURE_MIN_FILTER, (GLint)min_f);
+    glSamplerParameteri(s, GL_TEXTURE_MAG_FILTER, (GLint)mag_f);
+    glSamplerParameteri(s, GL_TEXTURE_WRAP_S, (GLint)wraps[wrap]);
+    glSamplerParameteri(s, GL_TEXTURE_WRAP_T, (GLint)wraps[wrap]);
+    r->tex_samplers[key] = s;
+    return s;
+}
+
+/* ── ENG_Image の転送 (形式ごと) ───────────────────────*/
+/* mips: 圧縮形式は同梱レベルを、それ以外は glGenerateMipmap で生成。
+ * 戻り値の *bytes はミップを含む GPU 上の推定サイズ */
+static GLuint upload_image(const ENG_Image* img, bool mips, size_t* bytes) {
+    const unsigned char* px = img->base + img->level_off[0];
+    int levels = 1;
+    GLuint tex;
+    if (img->format == ENG_TEXFMT_RGBA8) {
+        tex = upload_texture(px, img->w, img->h, 4);
+        glBindTexture(GL_TEXTURE_2D, tex);
+    } else {
+        glGenTextures(1, &tex);
+        glBindTexture(GL_TEXTURE_2D, tex);
+    }
+    switch (img->format) {
+        case ENG_TEXFMT_RGBA8:
+            break;
+        case ENG_TEXFMT_RGB565:
+        case ENG_TEXFMT_RGBA4444:
+        case ENG_TEXFMT_INDEX8: {
+            ENG_PixelFmt pf = pixel_fmt(img->format);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, pf.bpp);
+            glTexImage2D(GL_TEXTURE_2D, 0, (GLint)pf.ifmt, img->w, img->h, 0,
+                         pf.fmt, pf.type, px);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            break;
+        }
+        default: {
+            GLenum ifmt = (img->format == ENG_TEXFMT_BC1) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT :
+                          (img->format == ENG_TEXFMT_BC3) ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT :
+                                                            GL_COMPRESSED_RGBA_BPTC_UNORM;
+            /* 圧縮形式は GPU で生成できないので同梱分だけ */
+            levels = mips ? img->levels : 1;
+            int w = img->w, h = img->h;
+            *bytes = 0;
+            for (int i = 0; i < levels; ++i) {
+                glCompressedTexImage2D(GL_TEXTURE_2D, i, ifmt, w, h, 0,
+                                       (GLsizei)img->level_size[i],
+                                       img->base + img->level_off[i]);
+                *bytes += img->level_size[i];
+                if (w > 1) w /= 2;
+                if (h > 1) h /= 2;
+            }
+            break;
+        }
+    }
+    if (!eng_texfmt_compressed(img->format)) {
+        *bytes = img->level_size[0];
+        if (mips) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+            int w = img->w, h = img->h;
+            while (w > 1 || h > 1) {
+                if (w > 1) w /= 2;
+                if (h > 1) h /= 2;
+                *bytes += eng_texfmt_level_size(img->format, w, h);
+                ++levels;
+            }
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return tex;
+}
+
+/* ── エントリ参照 ───────────────────────────────────────*/
+/* 解放済み・世代違いの ID は NULL (1 回の比較で弾く) */
+static inline ENG_TexEntry* tex_get(ENG_Renderer* r, ENG_TexID id) {
+    return (ENG_TexEntry*)eng_slots_get(&r->textures, id);
+}
+
+static ENG_TexID alloc_entry(ENG_Renderer* r, ENG_TexEntry** out) {
+    ENG_TexID id = eng_slots_alloc(&r->textures);
+    if (!id) {
+        fprintf(stderr, "[eng_render] テクスチャを確保できません\n");
+        return 0;
+    }
+    *out = tex_get(r, id);
+    (*out)->refs = 1;
+    return id;
+}
+
+/* ── デコード済み画像をエントリに格納 ───────────────────*/
+/* RGBA8 でアトラスに収まればページへ、そうでなければ専用テクスチャへ。
+ * ミップ付き / CLAMP 以外はページ境界をまたいで読むのでアトラス不可 */
+static void store_image(ENG_Renderer* r, ENG_TexEntry* e, const ENG_Image* img) {
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    const unsigned char* px = img->base + img->level_off[0];
+    bool  atlas_ok = !e->mipmaps && ENG_SAMPLER_WRAP(e->samp_key) == ENG_WRAP_CLAMP;
+    float uv[4];
+    int   page;
+    if (img->format == ENG_TEXFMT_RGBA8 && atlas_ok &&
+        eng_atlas_add(r, px, img->w, img->h, &page, uv)) {
+        e->gl_id      = eng_atlas_page_tex(r, page);
+        e->atlas_page = page + 1;
+        e->u0 = uv[0]; e->v0 = uv[1]; e->u1 = uv[2]; e->v1 = uv[3];
+        e->bytes      = img->level_size[0];
+    } else {
+        e->gl_id      = upload_image(img, e->mipmaps, &e->bytes);
+        e->atlas_page = 0;
+        e->u0 = 0.0f; e->v0 = 0.0f; e->u1 = 1.0f; e->v1 = 1.0f;
+    }
+    e->w      = img->w;
+    e->h      = img->h;
+    e->format = img->format;
+    if (img->format == ENG_TEXFMT_INDEX8 && !e->palette) {  /* 再読込時は既存の行を使う */
+        e->palette = eng_palette_new(r, img->palette, img->palette_count, true);
+    }
+    r->tex_resident_bytes += e->bytes;
+    r->tex_upload_ticks   += SDL_GetPerformanceCounter() - t0;
+}
+
+/* 単一レベル RGBA8 のビュー (コピーなし) */
+static void rgba_view(ENG_Image* img, const unsigned char* rgba, int w, int h) {
+    memset(img, 0, sizeof(*img));
+    img->format        = ENG_TEXFMT_RGBA8;
+    img->w             = w;
+    img->h             = h;
+    img->levels        = 1;
+    img->base          = rgba;
+    img->level_size[0] = (size_t)w * (size_t)h * 4;
+}
+
+static void release_storage(ENG_Renderer* r, ENG_TexEntry* e) {
+    if (e->atlas_page > 0) eng_atlas_release(r, e->atlas_page - 1);
+    else if (e->gl_id)     glDeleteTextures(1, &e->gl_id);
+    r->tex_resident_bytes -= e->bytes;
+    e->bytes = 0;
+}
+
+/* ── パスキャッシュ (パス + 格納形式 + サンプラー → ID) ─*/
+/* バケットとエントリの hash_next には ID を入れる (0 = 終端) */
+static ENG_TexID cache_find(ENG_Renderer* r, const char* path, uint64_t hash,
+                            ENG_TexFormat want, uint8_t samp_key) {
+    if (r->tex_bucket_count == 0) return 0;
+    ENG_TexID id = r->tex_buckets[hash & (uint64_t)(r->tex_bucket_count - 1)];
+    while (id) {
+        const ENG_TexEntry* e = tex_get(r, id);
+        if (e->path_hash == hash && e->want == want && e->samp_key == samp_key &&
+            strcmp(e->path, path) == 0) return id;
+        id = e->hash_next;
+    }
+    return 0;
+}
+
+static void cache_link(ENG_Renderer* r, ENG_TexID id, ENG_TexEntry* e) {
+    ENG_TexID* head = &r->tex_buckets[e->path_hash & (uint64_t)(r->tex_bucket_count - 1)];
+    e->hash_next = *head;
+    *head = id;
+}
+
+static void cache_insert(ENG_Renderer* r, ENG_TexID id, const char* path, uint64_t hash) {
+    size_t len = strlen(path);
+    char*  dup = (char*)malloc(len + 1);
+    if (!dup) return;  /* キャッシュされないだけで読込自体は有効 */
+    memcpy(dup, path, len + 1);
+
+    /* 負荷率 1 を超えたらバケットを倍にして張り直す */
+    if (r->tex_cached + 1 > r->tex_bucket_count) {
+        int n = r->tex_bucket_count ? r->tex_bucket_count * 2 : 64;
+        ENG_TexID* b = (ENG_TexID*)calloc((size_t)n, sizeof(ENG_TexID));
+        if (!b) { free(dup); return; }
+        free(r->tex_buckets);
+        r->tex_buckets      = b;
+        r->tex_bucket_count = n;
+        for (int i = 0; i < r->textures.cap; ++i) {
+            ENG_TexID other = eng_slots_id_at(&r->textures, i);
+            ENG_TexEntry* oe = other ? tex_get(r, other) : NULL;
+            if (oe && oe->path) cache_link(r, other, oe);
+        }
+    }
+
+    ENG_TexEntry* e = tex_get(r, id);
+    e->path      = dup;
+    e->path_hash = hash;
+    cache_link(r, id, e);
+    r->tex_cached++;
+}
+
+static void cache_remove(ENG_Renderer* r, ENG_TexID id, ENG_TexEntry* e) {
+    if (!e->path) return;
+    ENG_TexID* link = &r->tex_buckets[e->path_hash & (uint64_t)(r->tex_bucket_count - 1)];
+    while (*link && *link != id) link = &tex_get(r, *link)->hash_next;
+    if (*link) *link = e->hash_next;
+    free(e->path);
+    e->path      = NULL;
+    e->hash_next = 0;
+    r->tex_cached--;
+}
+
+/* 同じパスが読込済みなら参照カウントを増やして返す */
+static ENG_TexID cache_acquire(ENG_Renderer* r, const char* path, uint64_t hash,
+                               ENG_TexFormat want, uint8_t samp_key) {
+    ENG_TexID hit = cache_find(r, path, hash, want, samp_key);
+    if (hit) {
+        tex_get(r, hit)->refs++;
+        r->tex_cache_hits++;
+    } else {
+        r->tex_cache_misses++;
+    }
+    return hit;
+}
+
+/* ── 再読込の結果 ───────────────────────────────────────*/
+#define RELOAD_RETRY_FRAMES 60  /* 失敗後に次を試すまでのフレーム数 (連続失敗ごとに倍, 上限 64 倍) */
+
+static void reload_done(ENG_Renderer* r, ENG_TexEntry* e) {
+    e->reload_fails = 0;
+    e->reload_at    = 0;
+    r->tex_reloads++;
+}
+
+/* 読めないファイル・閉じたパックを毎フレーム読みに行かない */
+static void reload_failed(ENG_Renderer* r, ENG_TexEntry* e) {
+    int shift = e->reload_fails < 6 ? e->reload_fails : 6;
+    if (e->reload_fails < UINT8_MAX) e->reload_fails++;
+    e->reload_at = r->tex_frame + ((uint64_t)RELOAD_RETRY_FRAMES << shift);
+    e->evicted   = true;
+}
+
+/* ── 非同期ロード要求 ───────────────────────────────────*/
+typedef struct {
+    ENG_Renderer*  r;
+    ENG_TexID      id;
+    char*          path;
+    ENG_TexFormat  want;
+    uint32_t       caps;     /* 開始時の r->tex_caps (ワーカーは r を読まない) */
+    bool           premul;   /* 開始時の r->premul_alpha */
+    bool           reload;   /* 追い出し後の読み直し (失敗してもエントリは残す) */
+    ENG_Image      img;      /* ワーカーが設定 */
+    bool           ok;
+    const char*    error;
+} ENG_TexLoadReq;
+
+static void free_load_req(ENG_TexLoadReq* req) {
+    eng_image_free(&req->img);
+    free(req->path);
+    free(req);
+}
+
+/* ワーカースレッド: デコードのみ (GL 呼び出しなし) */
+static void load_req_run(void* arg) {
+    ENG_TexLoadReq* req = (ENG_TexLoadReq*)arg;
+    req->ok = eng_image_load(req->path, req->want, req->premul, req->caps,
+                             &req->img, &req->error);
+}
+
+/* 描画スレッド: GL へ転送してエントリを確定 */
+static void load_req_done(void* arg, bool cancelled) {
+    ENG_TexLoadReq* req = (ENG_TexLoadReq*)arg;
+    req->r->tex_pending--;
+    /* 完了前に eng_free_texture された場合は世代が進んでいて引けない */
+    ENG_TexEntry* e = cancelled ? NULL : tex_get(req->r, req->id);
+    if (!e || !e->pending) { free_load_req(req); return; }
+
+    if (!req->ok) {
+        if (!req->reload || e->reload_fails == 0) {  /* 再読込の失敗は 1 回だけ出す */
+            fprintf(stderr, "[eng_render] テクスチャロード失敗: %s — %s\n",
+                    req->path, req->error ? req->error : "unknown");
+        }
+        if (req->reload) {  /* ID は生かしたまま、間隔を空けて読み直す */
+            e->pending = false;
+            reload_failed(req->r, e);
+            free_load_req(req);
+            return;
+        }
+        cache_remove(req->r, req->id, e);
+        eng_slots_free(&req->r->textures, req->id);
+        free_load_req(req);
+        return;
+    }
+    store_image(req->r, e, &req->img);
+    e->pending = false;
+    if (req->reload) reload_done(req->r, e);
+    free_load_req(req);
+}
+
+/* 読込指定をエントリに反映 (GL 転送前に設定しておく) */
+static void apply_params(ENG_TexEntry* e, const ENG_TexParams* p) {
+    e->want     = p->format;
+    e->mipmaps  = p->mipmaps;
+    e->samp_key = ENG_SAMPLER_KEY(p->filter, p->wrap, p->mipmaps);
+}
+
+/* 既存エントリのデコードをワーカーへ投げる (e の want / 形式指定を使う) */
+static bool submit_decode(ENG_Renderer* r, ENG_TexID id, ENG_TexEntry* e,
+                          const char* path, bool reload) {
+    ENG_TexLoadReq* req = (ENG_TexLoadReq*)calloc(1, sizeof(ENG_TexLoadReq));
+    size_t len = strlen(path);
+    char* dup  = (char*)malloc(len + 1);
+    if (!req || !dup) { free(req); free(dup); return false; }
+    memcpy(dup, path, len + 1);
+
+    req->r      = r;
+    req->id     = id;
+    req->path   = dup;
+    req->want   = e->want;
+    req->caps   = r->tex_caps;
+    req->premul = r->premul_alpha;
+    req->reload = reload;
+
+    if (!r->placeholder_tex) {
+        static const unsigned char clear_px[4] = { 0, 0, 0, 0 };
+        r->placeholder_tex = upload_texture(clear_px, 1, 1, 4);
+    }
+    if (!eng_jobs_submit(&r->jobs, load_req_run, load_req_done, req)) {
+        free_load_req(req);
+        return false;
+    }
+    e->pending = true;
+    r->tex_pending++;
+    return true;
+}
+
+static ENG_TexID load_async(ENG_Renderer* r, const char* path, uint64_t hash,
+                            const ENG_TexParams* p) {
+    ENG_TexEntry* e;
+    ENG_TexID id = alloc_entry(r, &e);
+    if (!id) return 0;
+    apply_params(e, p);
+    if (!submit_decode(r, id, e, path, false)) {
+        eng_slots_free(&r->textures, id);
+        return 0;
+    }
+    cache_insert(r, id, path, hash);
+    return id;
+}
+
 /* ── テクスチャロード ───────────────────────────────────*/
-ENG_TexID eng_load_texture(ENG_Renderer* r, const char* path) {
+ENG_TexID eng_load_texture_ex(ENG_Renderer* r, const char* path,
+                              const ENG_TexParams* params) {
     if (!r || !path) return 0;
+    ENG_TexParams p = { ENG_TEXFMT_RGBA8, false, false, ENG_FILTER_NEAREST, ENG_WRAP_CLAMP };
+    if (params) p = *params;
+    if (p.format != ENG_TEXFMT_RGB565 && p.format != ENG_TEXFMT_RGBA4444 &&
+        p.format != ENG_TEXFMT_INDEX8) {
+        p.format = ENG_TEXFMT_RGBA8;  /* 圧縮形式はファイル側で決まる */
+    }
+    if (p.format == ENG_TEXFMT_INDEX8) {  /* 番号を補間しても意味がない */
+        p.filter  = ENG_FILTER_NEAREST;
+        p.mipmaps = false;
+    }
+    if ((unsigned)p.filter > ENG_FILTER_TRILINEAR) p.filter = ENG_FILTER_NEAREST;
+    if ((unsigned)p.wrap > ENG_WRAP_MIRROR)        p.wrap   = ENG_WRAP_CLAMP;
+    if (p.filter == ENG_FILTER_TRILINEAR)          p.mipmaps = true;
+    sampler_for(r, p.filter, p.wrap, p.mipmaps);  /* 描画時は配列を引くだけ */
 
-    /* 空きスロットを探す */
-    int slot = -1;
-    for (int i = 0; i < ENG_MAX_TEXTURES; ++i) {
-        if (!r->textures[i].used) { slot = i; break; }
+    uint64_t  hash = eng_pack_hash(path);
+    ENG_TexID hit  = cache_acquire(r, path, hash, p.format,
+                                   ENG_SAMPLER_KEY(p.filter, p.wrap, p.mipmaps));
+    if (hit) return hit;
+    if (p.async) {
+        ENG_TexID id = load_async(r, path, hash, &p);
+        if (id) return id;
+        /* ワーカーを使えなければ (起動失敗・メモリ不足) その場でデコードして READY で返す */
     }
-    if (slot < 0) {
-        fprintf(stderr, "[eng_render] テクスチャスロット不足\n");
+
+    ENG_Image   img;
+    const char* err;
+    if (!eng_image_load(path, p.format, r->premul_alpha, r->tex_caps, &img, &err)) {
+        fprintf(stderr, "[eng_render] テクスチャロード失敗: %s — %s\n",
+                path, err ? err : "unknown");
         return 0;
     }
 
-    /* stb_image でロード (Y 軸を反転: OpenGL は Y 下→上) */
-    stbi_set_flip_vertically_on_load(0); /* スプライトは反転しない */
-    int w, h, ch;
-    unsigned char* pixels = stbi_load(path, &w, &h, &ch, 4);
-    if (!pixels) {
-        fprintf(stderr, "[eng_render] テクスチャロード失敗: %s — %s\n",
-                path, stbi_failure_reason());
+    ENG_TexEntry* e;
+    ENG_TexID id = alloc_entry(r, &e);
+    if (id) {
+        apply_params(e, &p);
+        store_image(r, e, &img);
+        cache_insert(r, id, path, hash);
+    }
+    eng_image_free(&img);
+    return id;
+}
+
+ENG_TexID eng_load_texture(ENG_Renderer* r, const char* path) {
+    return eng_load_texture_ex(r, path, NULL);
+}
+
+ENG_TexID eng_load_texture_async(ENG_Renderer* r, const char* path) {
+    ENG_TexParams p = { ENG_TEXFMT_RGBA8, true, false, ENG_FILTER_NEAREST, ENG_WRAP_CLAMP };
+    return eng_load_texture_ex(r, path, &p);
+}
+
+/* ── 一括ロード: デコードは全コアで並列、転送は順次 ───*/
+int eng_load_textures(ENG_Renderer* r, const char* const* paths, int n,
+                      ENG_TexID* ids_out, const ENG_TexParams* params) {
+    if (!r || !paths || !ids_out || n <= 0) return 0;
+    ENG_TexParams p = { ENG_TEXFMT_RGBA8, true, false, ENG_FILTER_NEAREST, ENG_WRAP_CLAMP };
+    if (params) p = *params;
+    p.async = true;
+
+    for (int i = 0; i < n; ++i) {
+        ids_out[i] = paths[i] ? eng_load_texture_ex(r, paths[i], &p) : 0;
+    }
+
+    /* 完了分を転送しつつ、手が空いたら描画スレッドもデコードに参加する */
+    int loaded = 0;
+    for (int i = 0; i < n; ++i) {
+        while (eng_tex_status(r, ids_out[i]) == ENG_TEX_PENDING) {
+            if (eng_jobs_pump(&r->jobs, 1e9) == 0 && !eng_jobs_help(&r->jobs)) {
+                eng_jobs_wait(&r->jobs, 5);
+            }
+        }
+        if (eng_tex_status(r, ids_out[i]) == ENG_TEX_READY) loaded++;
+        else ids_out[i] = 0;
+    }
+    return loaded;
+}
+
+/* ── デコード済み RGBA から生成 (アセットパック等) ─────*/
+static void store_rgba(ENG_Renderer* r, ENG_TexEntry* e, const unsigned char* rgba, int w, int h) {
+    /* 乗算済みモードでは変換したコピーを転送 (元はパックの読込専用領域) */
+    unsigned char* conv = NULL;
+    if (r->premul_alpha) {
+        size_t npx = (size_t)w * (size_t)h;
+        conv = (unsigned char*)malloc(npx * 4);
+        if (conv) eng_premultiply_rgba(conv, rgba, npx);
+    }
+    ENG_Image img;
+    rgba_view(&img, conv ? conv : rgba, w, h);
+    store_image(r, e, &img);
+    free(conv);
+}
+
+ENG_TexID eng_tex_create_rgba(ENG_Renderer* r, const unsigned char* rgba, int w, int h) {
+    ENG_TexEntry* e;
+    ENG_TexID id = alloc_entry(r, &e);
+    if (!id) return 0;
+    store_rgba(r, e, rgba, w, h);
+    return id;
+}
+
+/* パック由来のテクスチャは追い出し後にパックから読み直せるよう名前を控える */
+void eng_tex_set_pack_source(ENG_Renderer* r, ENG_TexID id, ENG_PackID pack, const char* name) {
+    ENG_TexEntry* e = tex_get(r, id);
+    if (!e) return;
+    size_t len = strlen(name);
+    free(e->src_name);
+    e->src_name = (char*)malloc(len + 1);
+    if (e->src_name) memcpy(e->src_name, name, len + 1);
+    e->src_pack = pack;
+}
+
+/* ── 動的テクスチャ ─────────────────────────────────────*/
+ENG_TexID eng_texture_create(ENG_Renderer* r, int w, int h, ENG_TexFormat fmt) {
+    if (!r || w <= 0 || h <= 0) return 0;
+    if ((unsigned)fmt > ENG_TEXFMT_INDEX8) {
+        fprintf(stderr, "[eng_render] 不明なテクスチャ形式: %d\n", (int)fmt);
         return 0;
     }
+    if (eng_texfmt_compressed(fmt)) {
+        fprintf(stderr, "[eng_render] 動的テクスチャに圧縮形式は使えません\n");
+        return 0;
+    }
+    ENG_TexEntry* e;
+    ENG_TexID id = alloc_entry(r, &e);
+    if (!id) return 0;
+    if (fmt == ENG_TEXFMT_INDEX8) {
+        /* 既定のパレットは番号 = 明るさの灰色 (eng_tex_palette で取得して書換える) */
+        unsigned char ramp[256 * 4];
+        for (int i = 0; i < 256; ++i) {
+            ramp[i * 4 + 0] = ramp[i * 4 + 1] = ramp[i * 4 + 2] = (unsigned char)i;
+            ramp[i * 4 + 3] = 255;
+        }
+        e->palette = eng_palette_new(r, ramp, 256, true);
+        if (!e->palette) {
+            eng_slots_free(&r->textures, id);
+            return 0;
+        }
+    }
+
+    ENG_PixelFmt pf = pixel_fmt(fmt);
+    glGenTextures(1, &e->gl_id);
+    glBindTexture(GL_TEXTURE_2D, e->gl_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, (GLint)pf.ifmt, w, h, 0, pf.fmt, pf.type, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    e->w      = w;
+    e->h      = h;
+    e->format = fmt;
+    e->want   = fmt;
+    e->u1     = 1.0f;
+    e->v1     = 1.0f;
+    e->bytes  = eng_texfmt_level_size(fmt, w, h);
+    r->tex_resident_bytes += e->bytes;
+    return id;
+}
+
+/* PBO リングの次のスロットへ書込む (成功時はバインドしたまま返す)。
+ * GPU がまだ前回の内容を読んでいればバッファを作り直して待たない */
+static ENG_PboSlot* pbo_write(ENG_Renderer* r, const void* pixels, size_t size, bool premul) {
+    ENG_PboSlot* s = &r->tex_pbo[r->tex_pbo_next];
+    r->tex_pbo_next = (r->tex_pbo_next + 1) % ENG_PBO_RING;
+
+    if (!s->buf) glGenBuffers(1, &s->buf);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, s->buf);
+    bool busy = s->fence &&
+                glClientWaitSync(s->fence, 0, 0) == GL_TIMEOUT_EXPIRED;
+    if (s->fence) { glDeleteSync(s->fence); s->fence = NULL; }
+    if (size > s->cap || busy) {
+        if (size > s->cap) s->cap = size;
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)s->cap, NULL, GL_STREAM_DRAW);
+    }
+    /* 使用中でないことを確認済みなので同期なしでマップできる */
+    void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+                                 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+                                 GL_MAP_UNSYNCHRONIZED_BIT);
+    if (!dst) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        return NULL;
+    }
+    if (premul) eng_premultiply_rgba((unsigned char*)dst, (const unsigned char*)pixels, size / 4);
+    else        memcpy(dst, pixels, size);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+    return s;
+}
+
+bool eng_texture_update(ENG_Renderer* r, ENG_TexID id,
+                        int x, int y, int w, int h, const void* pixels) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e || !pixels || w <= 0 || h <= 0) return false;
+    if (e->pending || e->atlas_page > 0 || eng_texfmt_compressed(e->format)) {
+        fprintf(stderr, "[eng_render] このテクスチャは更新できません (読込中/アトラス/圧縮)\n");
+        return false;
+    }
+    if (x < 0 || y < 0 || x + w > e->w || y + h > e->h) return false;
+
+    /* 更新前の内容で描くべきクワッドが溜まっていれば先に送る */
+    if (r->batch.quad_count > 0 && r->batch.current_tex == e->gl_id) eng_batch_flush(r);
+    eng_viewport_sync(r, e->gl_id);
+
+    Uint64 t0 = SDL_GetPerformanceCounter();
+    ENG_PixelFmt pf   = pixel_fmt(e->format);
+    size_t       size = (size_t)w * (size_t)h * (size_t)pf.bpp;
+    /* 乗算済みモードの RGBA8 は PBO へ書込みながら変換する */
+    bool         premul = r->premul_alpha && e->format == ENG_TEXFMT_RGBA8;
+    ENG_PboSlot* pbo    = pbo_write(r, pixels, size, premul);
+
+    unsigned char* conv = NULL;
+    if (!pbo && premul && (conv = (unsigned char*)malloc(size)) != NULL) {
+        eng_premultiply_rgba(conv, (const unsigned char*)pixels, size / 4);
+    }
+    glBindTexture(GL_TEXTURE_2D, e->gl_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, pf.bpp);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, pf.fmt, pf.type,
+                    pbo ? NULL : conv ? conv : pixels);  /* マップ失敗時は直接転送 */
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    free(conv);
+    if (e->mipmaps) glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (pbo) {
+        pbo->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    r->tex_upload_ticks += SDL_GetPerformanceCounter() - t0;
+    return true;
+}
+
+ENG_TexStatus eng_tex_status(ENG_Renderer* r, ENG_TexID id) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e) return ENG_TEX_INVALID;
+    return e->pending ? ENG_TEX_PENDING : ENG_TEX_READY;
+}
+
+int eng_tex_pending_count(ENG_Renderer* r) {
+    return r ? r->tex_pending : 0;  /* ジョブ数はグリフのラスタライズも含むので使わない */
+}
+
+void eng_set_upload_budget(ENG_Renderer* r, double ms) {
+    if (r) r->upload_budget_ms = ms > 0.0 ? ms : 0.0;
+}
+
+/* ── VRAM 予算 (LRU 追い出し / 再読込) ─────────────────*/
+void eng_set_texture_budget(ENG_Renderer* r, uint64_t bytes) {
+    if (r) r->tex_budget = bytes;
+}
+
+/* 読込元から作り直せる専用テクスチャだけが対象 (アトラスは領域を詰め直せない) */
+static inline bool evictable(ENG_Renderer* r, const ENG_TexEntry* e) {
+    if (!e->gl_id || e->pending || e->atlas_page != 0) return false;
+    if (e->src_name) return eng_pack_is_open(r, e->src_pack);  /* 閉じたパックからは戻せない */
+    return e->path != NULL;
+}
+
+static void evict(ENG_Renderer* r, ENG_TexEntry* e) {
+    if (r->batch.quad_count > 0 && r->batch.current_tex == e->gl_id) eng_batch_flush(r);
+    eng_viewport_sync(r, e->gl_id);
+    release_storage(r, e);  /* INDEX8 のパレット行は残す */
+    e->gl_id   = 0;
+    e->evicted = true;
+    r->tex_evictions++;
+}
+
+/* 追い出し済みを描こうとしたとき: パックは同期、ファイルは非同期で読み直す */
+static void reload(ENG_Renderer* r, ENG_TexID id, ENG_TexEntry* e) {
+    e->evicted = false;
+    if (e->src_name) {
+        int w, h;
+        const unsigned char* px = eng_pack_rgba(r, e->src_pack, e->src_name, &w, &h);
+        if (px) {
+            store_rgba(r, e, px, w, h);
+            reload_done(r, e);
+        } else {
+            if (e->reload_fails == 0) {
+                fprintf(stderr, "[eng_render] テクスチャ再読込失敗 (パックが閉じられた): %s\n",
+                        e->src_name);
+            }
+            reload_failed(r, e);
+        }
+        return;
+    }
+    if (submit_decode(r, id, e, e->path, true)) return;
+
+    /* ワーカーを使えなければその場でデコード */
+    ENG_Image   img;
+    const char* err;
+    if (!eng_image_load(e->path, e->want, r->premul_alpha, r->tex_caps, &img, &err)) {
+        if (e->reload_fails == 0) {
+            fprintf(stderr, "[eng_render] テクスチャ再読込失敗: %s — %s\n",
+                    e->path, err ? err : "unknown");
+        }
+        reload_failed(r, e);
+        return;
+    }
+    store_image(r, e, &img);
+    eng_image_free(&img);
+    reload_done(r, e);
+}
+
+static inline void touch(ENG_Renderer* r, ENG_TexID id, ENG_TexEntry* e) {
+    e->last_used = r->tex_frame;
+    if (e->evicted && r->tex_frame >= e->reload_at) reload(r, id, e);
+}
+
+typedef struct { uint64_t last_used; ENG_TexID id; } ENG_LruItem;
+
+static int cmp_lru(const void* a, const void* b) {
+    uint64_t x = ((const ENG_LruItem*)a)->last_used, y = ((const ENG_LruItem*)b)->last_used;
+    return x < y ? -1 : x > y;
+}
+
+void eng_tex_frame(ENG_Renderer* r) {
+    r->tex_frame++;
+    if (r->tex_budget == 0 || r->tex_resident_bytes <= r->tex_budget) return;
+
+    /* 直近 2 フレームに描いたものは次も描く可能性が高いので残す (毎フレームの読み直しを防ぐ) */
+    ENG_LruItem* items = (ENG_LruItem*)malloc((size_t)r->textures.count * sizeof(ENG_LruItem));
+    if (!items) return;
+    int n = 0;
+    for (int i = 0; i < r->textures.cap && n < r->textures.count; ++i) {
+        ENG_TexID id = eng_slots_id_at(&r->textures, i);
+        ENG_TexEntry* e = id ? tex_get(r, id) : NULL;
+        if (e && evictable(r, e) && e->last_used + 2 < r->tex_frame) {
+            items[n].last_used = e->last_used;
+            items[n].id        = id;
+            n++;
+        }
+    }
+    qsort(items, (size_t)n, sizeof(ENG_LruItem), cmp_lru);
+    for (int i = 0; i < n && r->tex_resident_bytes > r->tex_budget; ++i) {
+        evict(r, tex_get(r, items[i].id));
+    }
+    free(items);
+}
 
-    GLuint gl_id = upload_texture(pixels, w, h, 4);
-    stbi_image_free(pixels);
+/* ── 統計 ───────────────────────────────────────────────*/
+void eng_tex_stats(ENG_Renderer* r, ENG_TexStats* out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    if (!r) return;
+    out->textures       = r->textures.count;
+    out->cache_hits     = r->tex_cache_hits;
+    out->cache_misses   = r->tex_cache_misses;
+    uint64_t lookups    = r->tex_cache_hits + r->tex_cache_misses;
+    out->hit_rate       = lookups ? (double)r->tex_cache_hits / (double)lookups : 0.0;
+    out->resident_bytes = r->tex_resident_bytes;
+    out->upload_ms      = (double)r->tex_upload_ticks * 1000.0 /
+                          (double)SDL_GetPerformanceFrequency();
+    out->budget_bytes   = r->tex_budget;
+    out->evictions      = r->tex_evictions;
+    out->reloads        = r->tex_reloads;
+}
 
-    r->textures[slot].gl_id = gl_id;
-    r->textures[slot].w     = w;
-    r->textures[slot].h     = h;
-    r->textures[slot].used  = true;
-    r->tex_count++;
+/* ── 初期化 / 終了処理 (eng_create / eng_destroy から) ─*/
+/* GPU が直接扱える形式を拡張文字列から判定 */
+static uint32_t detect_caps(void) {
+    uint32_t caps = ENG_TEXCAP(ENG_TEXFMT_RGBA8) | ENG_TEXCAP(ENG_TEXFMT_RGB565) |
+                    ENG_TEXCAP(ENG_TEXFMT_RGBA4444) | ENG_TEXCAP(ENG_TEXFMT_INDEX8);
+    GLint n = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &n);
+    for (GLint i = 0; i < n; ++i) {
+        const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+        if (!ext) continue;
+        if (strcmp(ext, "GL_EXT_texture_compression_s3tc") == 0) {
+            caps |= ENG_TEXCAP(ENG_TEXFMT_BC1) | ENG_TEXCAP(ENG_TEXFMT_BC3);
+        } else if (strcmp(ext, "GL_ARB_texture_compression_bptc") == 0) {
+            caps |= ENG_TEXCAP(ENG_TEXFMT_BC7);
+        }
+    }
+    return caps;
+}
 
-    /* ID は slot + 1 (0 = 無効値 の予約) */
-    return (ENG_TexID)(slot + 1);
+void eng_tex_init(ENG_Renderer* r) {
+    eng_slots_init(&r->textures, sizeof(ENG_TexEntry));
+    r->tex_caps = detect_caps();
+}
+
+void eng_tex_shutdown(ENG_Renderer* r) {
+    eng_jobs_stop(&r->jobs);  /* 読込中のリクエストはキャンセルで解放 */
+    for (int i = 0; i < r->textures.cap; ++i) {
+        ENG_TexID id = eng_slots_id_at(&r->textures, i);
+        if (!id) continue;
+        ENG_TexEntry* e = tex_get(r, id);
+        if (e->gl_id && e->atlas_page == 0) glDeleteTextures(1, &e->gl_id);
+        free(e->path);
+        free(e->src_name);
+    }
+    eng_slots_destroy(&r->textures);
+    free(r->tex_buckets);
+    r->tex_buckets      = NULL;
+    r->tex_bucket_count = 0;
+    eng_atlas_shutdown(r);
+    if (r->placeholder_tex) glDeleteTextures(1, &r->placeholder_tex);
+    for (int i = 1; i < ENG_SAMPLER_KEYS; ++i) {
+        if (r->tex_samplers[i]) glDeleteSamplers(1, &r->tex_samplers[i]);
+    }
+    memset(r->tex_samplers, 0, sizeof(r->tex_samplers));
+    for (int i = 0; i < ENG_PBO_RING; ++i) {
+        ENG_PboSlot* s = &r->tex_pbo[i];
+        if (s->fence) glDeleteSync(s->fence);
+        if (s->buf)   glDeleteBuffers(1, &s->buf);
+    }
+    memset(r->tex_pbo, 0, sizeof(r->tex_pbo));
 }
 
 /* ── テクスチャ解放 ─────────────────────────────────────*/
 void eng_free_texture(ENG_Renderer* r, ENG_TexID id) {
-    if (!r || id == 0) return;
-    int slot = (int)id - 1;
-    if (slot < 0 || slot >= ENG_MAX_TEXTURES) return;
-    if (!r->textures[slot].used) return;
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e) return;
+    if (--e->refs > 0) return;  /* まだ他で使われている */
 
-    glDeleteTextures(1, &r->textures[slot].gl_id);
-    memset(&r->textures[slot], 0, sizeof(r->textures[slot]));
-    r->tex_count--;
+    cache_remove(r, id, e);
+    /* デコード中なら完了時に世代不一致で破棄される */
+    if (!e->pending) {
+        /* 溜まっている描画とビューポートの記録はまだこの GL 名 (アトラスなら領域) を使う */
+        if (e->gl_id) {
+            if (r->batch.quad_count > 0 && r->batch.current_tex == e->gl_id) eng_batch_flush(r);
+            eng_viewport_sync(r, e->gl_id);
+        }
+        release_storage(r, e);
+    }
+    eng_palette_release(r, e->palette);
+    free(e->src_name);
+    eng_slots_free(&r->textures, id);
 }
 
 /* ── クエリ ─────────────────────────────────────────────*/
 int eng_tex_width(ENG_Renderer* r, ENG_TexID id) {
-    if (!r || id == 0) return 0;
-    int slot = (int)id - 1;
-    return (slot >= 0 && slot < ENG_MAX_TEXTURES && r->textures[slot].used)
-           ? r->textures[slot].w : 0;
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    return e ? e->w : 0;
 }
 
 int eng_tex_height(ENG_Renderer* r, ENG_TexID id) {
-    if (!r || id == 0) return 0;
-    int slot = (int)id - 1;
-    return (slot >= 0 && slot < ENG_MAX_TEXTURES && r->textures[slot].used)
-           ? r->textures[slot].h : 0;
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    return e ? e->h : 0;
+}
+
+/* 格納形式 (読込中は指定形式) */
+ENG_TexFormat eng_tex_format(ENG_Renderer* r, ENG_TexID id) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e) return ENG_TEXFMT_RGBA8;
+    return e->pending ? e->want : e->format;
+}
+
+ENG_PaletteID eng_tex_palette(ENG_Renderer* r, ENG_TexID id) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    return e ? e->palette : 0;
+}
+
+size_t eng_tex_vram_bytes(ENG_Renderer* r, ENG_TexID id) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    return e ? e->bytes : 0;
+}
+
+bool eng_tex_format_supported(ENG_Renderer* r, ENG_TexFormat fmt) {
+    return r && (unsigned)fmt < 32 && (r->tex_caps & ENG_TEXCAP(fmt)) != 0;
 }
 
 /* ── テクスチャの GL ID を取得 (バッチ内部用) ──────────*/
 GLuint eng_tex_gl_id(ENG_Renderer* r, ENG_TexID id) {
-    if (!r || id == 0) return 0;
-    int slot = (int)id - 1;
-    return (slot >= 0 && slot < ENG_MAX_TEXTURES && r->textures[slot].used)
-           ? r->textures[slot].gl_id : 0;
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e) return 0;
+    touch(r, id, e);
+    return e->pending ? r->placeholder_tex : e->gl_id;
+}
+
+/* ── 描画用の解決 (アトラスのサブ矩形を含む) ───────────*/
+bool eng_tex_ref(ENG_Renderer* r, ENG_TexID id, ENG_TexRef* out) {
+    ENG_TexEntry* e = r ? tex_get(r, id) : NULL;
+    if (!e) return false;
+    touch(r, id, e);
+    out->pal_row = 0;
+    if (e->pending) {
+        out->gl_id   = r->placeholder_tex;
+        out->sampler = 0;
+        out->mode    = ENG_DRAW_TEX;
+        out->u0 = 0.0f; out->v0 = 0.0f; out->u1 = 1.0f; out->v1 = 1.0f;
+        return out->gl_id != 0;
+    }
+    if (!e->gl_id) return false;  /* 再読込に失敗した */
+    out->gl_id   = e->gl_id;
+    out->sampler = r->tex_samplers[e->samp_key];
+    out->u0 = e->u0; out->v0 = e->v0; out->u1 = e->u1; out->v1 = e->v1;
+    if (e->format == ENG_TEXFMT_INDEX8) {
+        if (!r->pal_tex) return false;  /* パレット未作成 (動的 INDEX8 のみ) */
+        out->mode    = ENG_DRAW_INDEXED;
+        out->pal_row = e->palette ? (int)e->palette - 1 : 0;
+    } else {
+        out->mode    = ENG_DRAW_TEX;
+    }
+    return true;
 }
@@ -0,0 +1,283 @@
+/**
+ * src/eng_viewport.c — ビューポート (画面分割) の記録と再生
+ *
+ * eng_viewport_begin〜end の間、eng_batch_flush は GPU に送る代わりに頂点と
+ * 描画状態 (テクスチャ・サンプラー・モード・ブレンド・クリップ) を記録する。
+ * end で記録頂点を専用 VBO へ 1 回だけ転送し、ビューポートごとに
+ * glViewport + glScissor + 投影行列を切り替えて、同じ範囲を glDrawElementsBaseVertex で描き直す。
+ * 4 人分の画面分割でも頂点の組み立て・転送は 1 回分で、増えるのは描画命令だけ。
+ */
+#include "eng_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static inline ENG_Viewport* vp_get(ENG_Renderer* r, int idx) {
+    if (!r || idx < 0 || idx >= ENG_MAX_VIEWPORTS || !r->viewports[idx].used) return NULL;
+    return &r->viewports[idx];
+}
+
+static void vp_update_view(ENG_Viewport* vp) {
+    eng_cam_build_view(vp->cam_x, vp->cam_y, vp->cam_zoom, vp->cam_rot_deg,
+                       vp->view, vp->view_inv);
+}
+
+/* ── 設定 ───────────────────────────────────────────────*/
+bool eng_viewport_set(ENG_Renderer* r, int idx, float x, float y, float w, float h) {
+    if (!r || idx < 0 || idx >= ENG_MAX_VIEWPORTS) return false;
+    ENG_Viewport* vp = &r->viewports[idx];
+    if (w <= 0.0f || h <= 0.0f) {
+        vp->used = false;
+        return true;
+    }
+    if (!vp->used) {
+        vp->cam_x = vp->cam_y = 0.0f;
+        vp->cam_zoom    = 1.0f;
+        vp->cam_rot_deg = 0.0f;
+        vp_update_view(vp);
+    }
+    vp->x = (int)x;
+    vp->y = (int)y;
+    vp->w = (int)w > 0 ? (int)w : 1;
+    vp->h = (int)h > 0 ? (int)h : 1;
+    vp->used = true;
+    return true;
+}
+
+void eng_viewport_cam(ENG_Renderer* r, int idx, float x, float y, float zoom, float degrees) {
+    ENG_Viewport* vp = vp_get(r, idx);
+    if (!vp || zoom <= 0.001f) return;
+    vp->cam_x = x; vp->cam_y = y;
+    vp->cam_zoom    = zoom;
+    vp->cam_rot_deg = degrees;
+    vp_update_view(vp);
+}
+
+void eng_viewport_clear(ENG_Renderer* r) {
+    if (!r) return;
+    if (r->vp_recording) eng_viewport_end(r);
+    for (int i = 0; i < ENG_MAX_VIEWPORTS; ++i) r->viewports[i].used = false;
+}
+
+/* ── 座標 ───────────────────────────────────────────────*/
+int eng_viewport_at(ENG_Renderer* r, float sx, float sy) {
+    if (!r) return -1;
+    for (int i = 0; i < ENG_MAX_VIEWPORTS; ++i) {
+        const ENG_Viewport* vp = &r->viewports[i];
+        if (vp->used && sx >= (float)vp->x && sx < (float)(vp->x + vp->w) &&
+            sy >= (float)vp->y && sy < (float)(vp->y + vp->h)) return i;
+    }
+    return -1;
+}
+
+bool eng_viewport_screen_to_world(ENG_Renderer* r, int idx, float sx, float sy,
+                                  float* wx, float* wy) {
+    const ENG_Viewport* vp = vp_get(r, idx);
+    if (!vp || !wx || !wy) return false;
+    const float* m = vp->view_inv;
+    float lx = sx - (float)vp->x, ly = sy - (float)vp->y;
+    *wx = m[0] * lx + m[2] * ly + m[4];
+    *wy = m[1] * lx + m[3] * ly + m[5];
+    return true;
+}
+
+/* ── 記録 ───────────────────────────────────────────────*/
+void eng_viewport_begin(ENG_Renderer* r) {
+    if (!r || r->vp_recording) return;
+    int i = 0;
+    while (i < ENG_MAX_VIEWPORTS && !r->viewports[i].used) ++i;
+    if (i == ENG_MAX_VIEWPORTS) return;  /* 通常どおり描く */
+    eng_batch_flush(r);
+    r->vp_recording = true;
+}
+
+static bool same_state(const ENG_ViewportCmd* c, const ENG_ViewportCmd* d) {
+    return c->tex == d->tex && c->sampler == d->sampler && c->mode == d->mode &&
+           c->premul == d->premul && c->additive == d->additive && c->clip == d->clip &&
+           (!c->clip || (c->clip_x == d->clip_x && c->clip_y == d->clip_y &&
+                         c->clip_w == d->clip_w && c->clip_h == d->clip_h));
+}
+
+void eng_viewport_record(ENG_Renderer* r) {
+    ENG_Batch* b = &r->batch;
+    int        n = b->quad_count;
+    b->quad_count = 0;
+
+    if (r->vp_quads + n > r->vp_quad_cap) {
+        int cap = r->vp_quad_cap ? r->vp_quad_cap : ENG_MAX_BATCH;
+        while (cap < r->vp_quads + n) cap *= 2;
+        ENG_Vertex* v = (ENG_Vertex*)realloc(r->vp_verts, (size_t)cap * 4 * sizeof(ENG_Vertex));
+        if (!v) {
+            fprintf(stderr, "[eng_render] ビューポート記録のメモリ不足 (%d クワッドを破棄)\n", n);
+            b->current_tex = 0;
+            b->current_sampler = 0;
+            return;
+        }
+        r->vp_verts = v; r->vp_quad_cap = cap;
+    }
+
+    ENG_ViewportCmd c = {
+        r->vp_quads, n, b->current_tex, b->current_sampler, b->mode,
+        r->premul_alpha, r->additive, r->clip_active, 0, 0, 0, 0
+    };
+    if (c.clip) {
+        c.clip_x = r->clip_x;
+        c.clip_y = r->win_h - r->clip_y - r->clip_h;  /* 左上基準に戻す */
+        c.clip_w = r->clip_w;
+        c.clip_h = r->clip_h;
+    }
+    memcpy(r->vp_verts + (size_t)r->vp_quads * 4, b->verts, (size_t)n * 4 * sizeof(ENG_Vertex));
+    r->vp_quads += n;
+    b->current_tex     = 0;
+    b->current_sampler = 0;
+
+    /* カメラ変更などで切れただけなら前の分に継ぎ足す */
+    ENG_ViewportCmd* last = r->vp_cmd_count ? &r->vp_cmds[r->vp_cmd_count - 1] : NULL;
+    if (last && same_state(last, &c) && last->first + last->quads == c.first) {
+        last->quads += n;
+        return;
+    }
+    if (r->vp_cmd_count + 1 > r->vp_cmd_cap) {
+        int cap = r->vp_cmd_cap ? r->vp_cmd_cap * 2 : 64;
+        ENG_ViewportCmd* cmds = (ENG_ViewportCmd*)realloc(r->vp_cmds, (size_t)cap * sizeof(ENG_ViewportCmd));
+        if (!cmds) {
+            r->vp_quads -= n;
+            return;
+        }
+        r->vp_cmds = cmds; r->vp_cmd_cap = cap;
+    }
+    r->vp_cmds[r->vp_cmd_count++] = c;
+}
+
+/* ── 再生 ───────────────────────────────────────────────*/
+static bool ensure_buffers(ENG_Renderer* r) {
+    if (!r->vp_vao) {
+        glGenVertexArrays(1, &r->vp_vao);
+        glGenBuffers(1, &r->vp_vbo);
+        if (!r->vp_vao || !r->vp_vbo) return false;
+        glBindVertexArray(r->vp_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, r->vp_vbo);
+        eng_batch_layout();
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, r->batch.ibo);  /* 4 頂点 6 インデックスの並びを共用 */
+    } else {
+        glBindVertexArray(r->vp_vao);
+        glBindBuffer(GL_ARRAY_BUFFER, r->vp_vbo);
+    }
+    /* 毎回確保し直して (orphan) 前フレームの描画完了を待たない */
+    if (r->vp_vbo_quads < r->vp_quads) r->vp_vbo_quads = r->vp_quad_cap;
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)r->vp_vbo_quads * 4 * sizeof(ENG_Vertex),
+                 NULL, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)r->vp_quads * 4 * sizeof(ENG_Vertex),
+                    r->vp_verts);
+    return true;
+}
+
+/* ビューポート (GL 座標の gx, gy, w, h) 内のクリップ矩形をビューポートで切り詰める */
+static void set_scissor(const ENG_Renderer* r, const ENG_ViewportCmd* c,
+                        int gx, int gy, int w, int h) {
+    if (!c->clip) {
+        eng_gl_scissor(r, gx, gy, w, h);
+        return;
+    }
+    int x0 = gx + c->clip_x, y0 = gy + h - (c->clip_y + c->clip_h);
+    int x1 = x0 + c->clip_w, y1 = y0 + c->clip_h;
+    if (x0 < gx)     x0 = gx;
+    if (y0 < gy)     y0 = gy;
+    if (x1 > gx + w) x1 = gx + w;
+    if (y1 > gy + h) y1 = gy + h;
+    eng_gl_scissor(r, x0, y0, x1 > x0 ? x1 - x0 : 0, y1 > y0 ? y1 - y0 : 0);
+}
+
+static void replay(ENG_Renderer* r) {
+    ENG_Batch* b = &r->batch;
+    eng_glyph_upload(r);
+    if (!ensure_buffers(r)) {
+        r->vp_quads = r->vp_cmd_count = 0;
+        return;
+    }
+    glUseProgram(b->prog);
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, r->pal_tex);
+    glUniform1i(b->loc_pal, 1);
+    glActiveTexture(GL_TEXTURE0);
+    glUniform1i(b->loc_tex, 0);
+    glEnable(GL_SCISSOR_TEST);
+
+    for (int v = 0; v < ENG_MAX_VIEWPORTS; ++v) {
+        const ENG_Viewport* vp = &r->viewports[v];
+        if (!vp->used) continue;
+        int gx = vp->x, gy = r->win_h - (vp->y + vp->h);  /* OpenGL は下基準 */
+        float proj[16];
+        eng_view_proj(vp->view, vp->w, vp->h, proj);
+        eng_gl_viewport(r, gx, gy, vp->w, vp->h);
+        glUniformMatrix4fv(b->loc_proj, 1, GL_FALSE, proj);
+
+        const ENG_ViewportCmd* prev = NULL;
+        for (int i = 0; i < r->vp_cmd_count; ++i) {
+            const ENG_ViewportCmd* c = &r->vp_cmds[i];
+            if (!prev || c->mode != prev->mode) glUniform1i(b->loc_mode, c->mode);
+            if (c->mode != ENG_DRAW_COLOR) {
+                if (!prev || c->tex != prev->tex) glBindTexture(GL_TEXTURE_2D, c->tex);
+                if (b->bound_sampler != c->sampler) {
+                    glBindSampler(0, c->sampler);
+                    b->bound_sampler = c->sampler;
+                }
+            }
+            if (!prev || c->premul != prev->premul || c->additive != prev->additive)
+                eng_batch_blend(c->premul, c->additive);
+            if (!prev || c->clip != prev->clip || c->clip)
+                set_scissor(r, c, gx, gy, vp->w, vp->h);
+
+            /* インデックスは ENG_MAX_BATCH クワッド分なので、それを超える範囲は分けて描く */
+            for (int q = 0; q < c->quads; q += ENG_MAX_BATCH) {
+                int n = c->quads - q < ENG_MAX_BATCH ? c->quads - q : ENG_MAX_BATCH;
+                glDrawElementsBaseVertex(GL_TRIANGLES, n * 6, GL_UNSIGNED_INT, NULL,
+                                         (c->first + q) * 4);
+            }
+            prev = c;
+        }
+    }
+
+    /* 画面全体 + 通常のカメラ・クリップ・ブレンドに戻す */
+    glBindVertexArray(0);
+    eng_gl_viewport(r, 0, 0, r->win_w, r->win_h);
+    if (r->clip_active) eng_gl_scissor(r, r->clip_x, r->clip_y, r->clip_w, r->clip_h);
+    else                glDisable(GL_SCISSOR_TEST);
+    eng_batch_blend(r->premul_alpha, r->additive);
+    eng_update_proj(r);
+    r->vp_quads     = 0;
+    r->vp_cmd_count = 0;
+}
+
+void eng_viewport_end(ENG_Renderer* r) {
+    if (!r || !r->vp_recording) return;
+    eng_batch_flush(r);  /* 残りも記録へ */
+    if (r->vp_cmd_count > 0) replay(r);
+    r->vp_recording = false;
+}
+
+/* テクスチャ・パレットの書換えやグリフページの破棄の前に呼ぶ。
+ * 記録分は書換え前の内容で描くべきなので、先に全ビューポートへ描いてしまう */
+void eng_viewport_sync(ENG_Renderer* r, GLuint tex) {
+    if (!r->vp_recording || r->vp_cmd_count == 0) return;
+    if (tex) {
+        int i = 0;
+        while (i < r->vp_cmd_count && r->vp_cmds[i].tex != tex) ++i;
+        if (i == r->vp_cmd_count) return;
+    }
+    replay(r);
+}
+
+/* ── 終了処理 (eng_destroy から) ───────────────────────*/
+void eng_viewport_shutdown(ENG_Renderer* r) {
+    if (r->vp_vao) glDeleteVertexArrays(1, &r->vp_vao);
+    if (r->vp_vbo) glDeleteBuffers(1, &r->vp_vbo);
+    free(r->vp_verts);
+    free(r->vp_cmds);
+    r->vp_vao = r->vp_vbo = 0;
+    r->vp_verts = NULL;
+    r->vp_cmds  = NULL;
+    r->vp_quads = r->vp_quad_cap = r->vp_vbo_quads = 0;
+    r->vp_cmd_count = r->vp_cmd_cap = 0;
+    r->vp_recording = false;
+}
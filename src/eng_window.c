@@ -8,46 +8,29 @@
 #include <time.h>
 
 /* ── ヘルパー: 投影行列の更新 ──────────────────────────*/
+/* スクリーン→NDC の正射影:
+ *   x' = x * 2/W - 1
+ *   y' = y * -2/H + 1  (Y反転)
+ * これをビュー行列 v (world→screen) の後に掛ける。
+ * 列優先行列 (OpenGL標準): proj[col*4 + row] */
+void eng_view_proj(const float* v, int w, int h, float* proj) {
+    float sx = 2.0f / (float)w, sy = -2.0f / (float)h;
+    memset(proj, 0, 16 * sizeof(float));
+    proj[0]  = sx * v[0];        proj[1]  = sy * v[1];
+    proj[4]  = sx * v[2];        proj[5]  = sy * v[3];
+    proj[10] = 1.0f;
+    proj[12] = sx * v[4] - 1.0f; proj[13] = sy * v[5] + 1.0f;
+    proj[15] = 1.0f;
+}
+
 void eng_update_proj(ENG_Renderer* r) {
     /* 直交投影 + カメラ変換
      * 基底: (0,0) 左上、(win_w, win_h) 右下
-     * カメラ: 平行移動 + ズーム + 回転
-     */
-    float W  = (float)r->win_w;
-    float H  = (float)r->win_h;
-    float cx = r->cam_x;
-    float cy = r->cam_y;
-    float z  = r->cam_zoom;
-    float a  = r->cam_rot_deg * (float)(3.14159265358979323846 / 180.0);
-    float ca = cosf(a), sa = sinf(a);
-
-    /* ortho(-W/2, W/2, H/2, -H/2) → view space
-     * +カメラ変換 (転置してから構築)
-     * 列優先行列 (OpenGL標準) */
-    float sx = 2.0f / W, sy = -2.0f / H;
-    /* スクリーン→NDC の正射影:
-     *   x' = (x - W/2) * 2/W
-     *   y' = (y - H/2) * -2/H  (Y反転)
-     * カメラ適用後:
-     *   xw = (x - cx) * z
-     * → x' = (xw - W/2) * 2/W
+     * カメラ: 平行移動 + ズーム + 回転 (ビュー行列は eng_cam_update_view)
      */
-    /* combined ortho * camera */
-    /* column-major: proj[col][row] */
+    eng_cam_update_view(r);
     float proj[16];
-    memset(proj, 0, sizeof(proj));
-    /* scale by zoom and ortho */
-    float rsx = sx * z * ca;
-    float rsy = sx * z * sa;
-    float rtx = sx * z * (-cx * ca - cy * sa) - 1.0f;
-    float rsx2 = sy * z * (-sa);
-    float rsy2 = sy * z * ca;
-    float rty  = sy * z * (cx * sa - cy * ca) + 1.0f;
-
-    proj[0]  = rsx;   proj[1]  = rsx2; proj[2]  = 0; proj[3]  = 0;
-    proj[4]  = rsy;   proj[5]  = rsy2; proj[6]  = 0; proj[7]  = 0;
-    proj[8]  = 0;     proj[9]  = 0;    proj[10] = 1; proj[11] = 0;
-    proj[12] = rtx;   proj[13] = rty;  proj[14] = 0; proj[15] = 1;
+    eng_view_proj(r->view, r->win_w, r->win_h, proj);
 
     glUseProgram(r->batch.prog);
     glUniformMatrix4fv(r->batch.loc_proj, 1, GL_FALSE, proj);
@@ -114,11 +97,24 @@ ENG_Renderer* eng_create(const char* title, int width, int height) {
     r->win_w   = dw;
     r->win_h   = dh;
     r->cam_zoom = 1.0f;
+    r->render_scale = 1.0f;
+    r->scale_min    = 0.5f;
+    r->scale_max    = 1.0f;
+    r->target_scale = 1.0f;
 
     /* タイミング初期化 */
     r->start_tick = SDL_GetPerformanceCounter();
     r->prev_tick  = r->start_tick;
     r->fps        = 60.0;
+    r->upload_budget_ms = 2.0;
+    r->pacing       = ENG_PACE_HYBRID;
+    r->pace_spin_ms = 2.0;
+    r->vsync        = ENG_VSYNC_ON;
+
+    /* テクスチャ / フォントのハンドル表 */
+    eng_tex_init(r);
+    eng_font_init(r);
+    eng_text_init(r);
 
     /* キー入力初期化 */
     r->key_state = SDL_GetKeyboardState(NULL);
@@ -153,8 +149,8 @@ bool eng_update(ENG_Renderer* r) {
     uint64_t now   = SDL_GetPerformanceCounter();
     uint64_t freq  = SDL_GetPerformanceFrequency();
     r->delta       = (double)(now - r->prev_tick) / (double)freq;
+    eng_frame_fixed(r, r->delta);       /* 固定ステップは切り詰める前の実時間で */
     if (r->delta > 0.1) r->delta = 0.1; /* 最大 0.1s */
-    r->fps         = (r->delta > 0.0) ? 1.0 / r->delta : 60.0;
     r->prev_tick   = now;
 
     /* キー状態を前フレームに保存 */
@@ -172,7 +168,7 @@ bool eng_update(ENG_Renderer* r) {
         if (ev.type == SDL_WINDOWEVENT &&
             ev.window.event == SDL_WINDOWEVENT_RESIZED) {
             SDL_GL_GetDrawableSize(r->window, &r->win_w, &r->win_h);
-            glViewport(0, 0, r->win_w, r->win_h);
+            eng_gl_viewport(r, 0, 0, r->win_w, r->win_h);
             eng_update_proj(r);
         }
         if (ev.type == SDL_MOUSEWHEEL) {
@@ -188,17 +184,20 @@ bool eng_update(ENG_Renderer* r) {
     r->mouse_x = (float)mx;
     r->mouse_y = (float)my;
 
-    /* FPS キャップ */
-    if (r->fps_cap > 0) {
-        uint64_t freq     = SDL_GetPerformanceFrequency();
-        uint64_t target   = freq / (uint64_t)r->fps_cap;
-        uint64_t elapsed  = SDL_GetPerformanceCounter() - r->frame_end_tick;
-        if (elapsed < target) {
-            uint32_t wait_ms = (uint32_t)(((target - elapsed) * 1000) / freq);
-            if (wait_ms > 0) SDL_Delay(wait_ms);
-        }
-    }
-    r->frame_end_tick = SDL_GetPerformanceCounter();
+    /* 非同期ロード完了分を GL へ転送 (予算内) */
+    eng_jobs_pump(&r->jobs, r->upload_budget_ms);
+
+    /* ワーカーで完成したグリフをキャッシュへ (件数の予算内) */
+    eng_font_frame(r);
+
+    /* VRAM 予算を超えていれば使われていないテクスチャを追い出す */
+    eng_tex_frame(r);
+
+    /* FPS キャップ (寝る + 高精度カウンタでスピン) */
+    eng_frame_pace(r);
+
+    /* 解像度スケール: このフレームの場面を縮小 FBO へ */
+    eng_scale_frame_begin(r);
 
     return true;
 }
@@ -207,20 +206,22 @@ bool eng_update(ENG_Renderer* r) {
 void eng_destroy(ENG_Renderer* r) {
     if (!r) return;
 
-    /* テクスチャ解放 */
-    for (int i = 0; i < ENG_MAX_TEXTURES; ++i) {
-        if (r->textures[i].used) {
-            glDeleteTextures(1, &r->textures[i].gl_id);
-        }
-    }
+    /* テクスチャ解放 (ワーカー停止を含む) */
+    eng_tex_shutdown(r);
 
     /* フォント解放 */
-    for (int i = 0; i < ENG_MAX_FONTS; ++i) {
-        if (r->fonts[i].used) {
-            glDeleteTextures(1, &r->fonts[i].atlas_tex);
-            free(r->fonts[i].baked);
-        }
-    }
+    eng_text_shutdown(r);
+    eng_font_shutdown(r);
+
+    /* アセットパック */
+    eng_pack_shutdown(r);
+
+    /* パレット */
+    eng_palette_shutdown(r);
+
+    /* ビューポート / 解像度スケール */
+    eng_viewport_shutdown(r);
+    eng_scale_shutdown(r);
 
     /* バッチ解放 */
     if (r->batch.vao) glDeleteVertexArrays(1, &r->batch.vao);
@@ -270,7 +271,7 @@ float eng_mouse_wheel(ENG_Renderer* r) { return r ? r->mouse_wheel : 0.0f; }
 void eng_set_fps_cap(ENG_Renderer* r, int fps) {
     if (r) {
         r->fps_cap = fps;
-        r->frame_end_tick = SDL_GetPerformanceCounter();
+        r->pace_deadline = 0;  /* 次のフレームを基準に取り直す */
     }
 }
 
@@ -286,7 +287,7 @@ void eng_set_fullscreen(ENG_Renderer* r, bool fullscreen) {
     Uint32 flags = fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0;
     SDL_SetWindowFullscreen(r->window, flags);
     SDL_GetWindowSize(r->window, &r->win_w, &r->win_h);
-    glViewport(0, 0, r->win_w, r->win_h);
+    eng_gl_viewport(r, 0, 0, r->win_w, r->win_h);
     eng_update_proj(r);
 }
 
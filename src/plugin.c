@@ -7,6 +7,7 @@
 #include "eng_render.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static ENG_Renderer* g_r = NULL;
 
@@ -21,6 +22,19 @@ static ENG_Renderer* g_r = NULL;
 #define NUL        hajimu_null()
 #define STR(s)     hajimu_string(s)
 
+/* 要素 n 個の配列値 (要素はすべて null で初期化) */
+static Value make_array(int n) {
+    Value v = NUL;
+    Value* el = (Value*)malloc((size_t)(n > 0 ? n : 1) * sizeof(Value));
+    if (!el) return v;
+    for (int i = 0; i < n; ++i) el[i] = NUL;
+    v.type           = VALUE_ARRAY;
+    v.array.elements = el;
+    v.array.length   = n;
+    v.array.capacity = n > 0 ? n : 1;
+    return v;
+}
+
 /* ================================================================
  * ライフサイクル
  * ================================================================ */
@@ -59,6 +73,41 @@ static Value fn_マウスホイール(int argc, Value* args)    { (void)argc; (v
 
 /* FPS キャップ */
 static Value fn_FPS上限設定(int argc, Value* args) { eng_set_fps_cap(g_r, ARG_INT(0)); return hajimu_null(); }
+static Value fn_ペーシング設定(int argc, Value* args) {
+    /* "スリープ" / "ハイブリッド" / "スピン" */
+    const char* m = ARG_STR(0);
+    eng_set_pacing(g_r, strcmp(m, "スリープ") == 0 ? ENG_PACE_SLEEP
+                      : strcmp(m, "スピン") == 0   ? ENG_PACE_SPIN : ENG_PACE_HYBRID);
+    return NUL;
+}
+static Value fn_垂直同期設定(int argc, Value* args) {
+    /* "オン" / "オフ" / "適応" */
+    const char* m = ARG_STR(0);
+    return BVAL(eng_set_vsync(g_r, strcmp(m, "オフ") == 0 ? ENG_VSYNC_OFF
+                                 : strcmp(m, "適応") == 0 ? ENG_VSYNC_ADAPTIVE : ENG_VSYNC_ON));
+}
+static Value fn_固定ステップ設定(int argc, Value* args) {
+    eng_set_fixed_step(g_r, ARG_NUM(0), argc > 1 ? ARG_INT(1) : 0);
+    return NUL;
+}
+static Value fn_固定ステップ数(int argc, Value* args) { (void)argc; (void)args; return NUM(eng_fixed_steps(g_r)); }
+static Value fn_固定ステップ秒(int argc, Value* args) { (void)argc; (void)args; return NUM(eng_fixed_dt(g_r)); }
+static Value fn_補間係数(int argc, Value* args)       { (void)argc; (void)args; return NUM(eng_fixed_alpha(g_r)); }
+static Value fn_フレーム統計(int argc, Value* args) {
+    /* 項目名: "p50" / "p95" / "p99" / "最大" / "平均" / "フレーム数" / "ヒッチ" / "ヒッチ累計" */
+    ENG_FrameStats st;
+    eng_frame_stats(g_r, &st);
+    const char* key = ARG_STR(0);
+    if (strcmp(key, "p50") == 0)        return NUM(st.p50_ms);
+    if (strcmp(key, "p95") == 0)        return NUM(st.p95_ms);
+    if (strcmp(key, "p99") == 0)        return NUM(st.p99_ms);
+    if (strcmp(key, "最大") == 0)       return NUM(st.max_ms);
+    if (strcmp(key, "平均") == 0)       return NUM(st.avg_ms);
+    if (strcmp(key, "フレーム数") == 0) return NUM(st.frames);
+    if (strcmp(key, "ヒッチ") == 0)     return NUM(st.hitches);
+    if (strcmp(key, "ヒッチ累計") == 0) return NUM(st.hitch_total);
+    return NUL;
+}
 
 /* クリッピング */
 static Value fn_クリップ開始(int argc, Value* args) { eng_clip_begin(g_r, ARG_F(0), ARG_F(1), ARG_F(2), ARG_F(3)); return hajimu_null(); }
@@ -90,6 +139,8 @@ static Value fn_描画クリア(int argc, Value* args) {
     eng_clear(g_r, ARG_F(0), ARG_F(1), ARG_F(2), argc > 3 ? ARG_F(3) : 1.0f);
     return NUL;
 }
+static Value fn_乗算済みアルファ設定(int argc, Value* args) { eng_set_premultiplied_alpha(g_r, ARG_B(0)); return NUL; }
+static Value fn_加算合成(int argc, Value* args)           { eng_set_additive(g_r, ARG_B(0)); return NUL; }
 static Value fn_描画フラッシュ(int argc, Value* args) {
     (void)argc; (void)args;
     eng_flush(g_r);
@@ -103,6 +154,122 @@ static Value fn_テクスチャ読込(int argc, Value* args)  { return NUM(eng_l
 static Value fn_テクスチャ削除(int argc, Value* args)  { eng_free_texture(g_r, (ENG_TexID)ARG_INT(0)); return NUL; }
 static Value fn_テクスチャ幅(int argc, Value* args)    { return NUM(eng_tex_width(g_r, (ENG_TexID)ARG_INT(0))); }
 static Value fn_テクスチャ高さ(int argc, Value* args)  { return NUM(eng_tex_height(g_r, (ENG_TexID)ARG_INT(0))); }
+static Value fn_テクスチャ非同期読込(int argc, Value* args) { return NUM(eng_load_texture_async(g_r, ARG_STR(0))); }
+static Value fn_テクスチャ読込完了(int argc, Value* args)  { return BVAL(eng_tex_status(g_r, (ENG_TexID)ARG_INT(0)) == ENG_TEX_READY); }
+static Value fn_テクスチャ読込中件数(int argc, Value* args) { (void)argc; (void)args; return NUM(eng_tex_pending_count(g_r)); }
+static Value fn_転送予算設定(int argc, Value* args)       { eng_set_upload_budget(g_r, ARG_NUM(0)); return NUL; }
+static Value fn_アトラス設定(int argc, Value* args)       { eng_set_texture_atlas(g_r, ARG_INT(0)); return NUL; }
+static Value fn_テクスチャ予算設定(int argc, Value* args) {
+    /* メガバイト単位 (0 以下 = 無制限) */
+    double mb = ARG_NUM(0);
+    eng_set_texture_budget(g_r, mb > 0.0 ? (uint64_t)(mb * 1024.0 * 1024.0) : 0);
+    return NUL;
+}
+static Value fn_テクスチャ統計(int argc, Value* args) {
+    /* 項目名: "ヒット率" / "使用バイト" / "枚数" / "ヒット" / "ミス" / "追い出し" / "再読込" */
+    ENG_TexStats st;
+    eng_tex_stats(g_r, &st);
+    const char* key = ARG_STR(0);
+    if (strcmp(key, "ヒット率") == 0)   return NUM(st.hit_rate);
+    if (strcmp(key, "使用バイト") == 0) return NUM(st.resident_bytes);
+    if (strcmp(key, "枚数") == 0)       return NUM(st.textures);
+    if (strcmp(key, "ヒット") == 0)     return NUM(st.cache_hits);
+    if (strcmp(key, "ミス") == 0)       return NUM(st.cache_misses);
+    if (strcmp(key, "転送ms") == 0)     return NUM(st.upload_ms);
+    if (strcmp(key, "追い出し") == 0)   return NUM(st.evictions);
+    if (strcmp(key, "再読込") == 0)     return NUM(st.reloads);
+    return NUL;
+}
+
+/* 形式名 ⇔ ENG_TexFormat */
+static const char* const k_tex_formats[] = { "RGBA8", "RGB565", "RGBA4444", "BC1", "BC3", "BC7", "INDEX8" };
+
+/* 非圧縮形式名 → ENG_TexFormat (該当なしは RGBA8) */
+static ENG_TexFormat tex_format_arg(const char* name) {
+    static const ENG_TexFormat fmts[] = { ENG_TEXFMT_RGB565, ENG_TEXFMT_RGBA4444, ENG_TEXFMT_INDEX8 };
+    for (int i = 0; i < 3; ++i) {
+        if (strcmp(name, k_tex_formats[fmts[i]]) == 0) return fmts[i];
+    }
+    return ENG_TEXFMT_RGBA8;
+}
+
+static Value fn_テクスチャ形式読込(int argc, Value* args) {
+    /* 形式: "RGBA8" / "RGB565" / "RGBA4444" / "INDEX8" (圧縮形式はファイル側で決まる) */
+    ENG_TexParams p = { tex_format_arg(ARG_STR(1)), ARG_B(2), false, ENG_FILTER_NEAREST, ENG_WRAP_CLAMP };
+    return NUM(eng_load_texture_ex(g_r, ARG_STR(0), &p));
+}
+static Value fn_テクスチャ形式(int argc, Value* args) {
+    return STR(k_tex_formats[eng_tex_format(g_r, (ENG_TexID)ARG_INT(0))]);
+}
+static Value fn_テクスチャ読込設定(int argc, Value* args) {
+    /* フィルタ: "最近傍" / "線形" / "トライリニア"  ラップ: "クランプ" / "リピート" / "ミラー" */
+    static const char* const filters[] = { "最近傍", "線形", "トライリニア" };
+    static const char* const wraps[]   = { "クランプ", "リピート", "ミラー" };
+    ENG_TexParams p = { ENG_TEXFMT_RGBA8, ARG_B(4), ARG_B(3), ENG_FILTER_NEAREST, ENG_WRAP_CLAMP };
+    for (int i = 0; i < 3; ++i) {
+        if (strcmp(ARG_STR(1), filters[i]) == 0) p.filter = (ENG_TexFilter)i;
+        if (strcmp(ARG_STR(2), wraps[i]) == 0)   p.wrap   = (ENG_TexWrap)i;
+    }
+    return NUM(eng_load_texture_ex(g_r, ARG_STR(0), &p));
+}
+static Value fn_テクスチャ作成(int argc, Value* args) {
+    return NUM(eng_texture_create(g_r, ARG_INT(0), ARG_INT(1), tex_format_arg(ARG_STR(2))));
+}
+static Value fn_テクスチャ更新(int argc, Value* args) {
+    /* バイト列は文字列値で渡す (NUL を含んでよい, 長さは string.length) */
+    if (argc < 6 || args[5].type != VALUE_STRING) return BVAL(false);
+    ENG_TexID id = (ENG_TexID)ARG_INT(0);
+    int w = ARG_INT(3), h = ARG_INT(4);
+    ENG_TexFormat fmt = eng_tex_format(g_r, id);
+    size_t bpp  = fmt == ENG_TEXFMT_RGBA8 ? 4 : fmt == ENG_TEXFMT_INDEX8 ? 1 : 2;
+    size_t need = (size_t)(w > 0 ? w : 0) * (size_t)(h > 0 ? h : 0) * bpp;
+    if ((size_t)args[5].string.length < need) {
+        fprintf(stderr, "[eng_render] テクスチャ更新: バイト列が不足 (%zu < %zu)\n",
+                (size_t)args[5].string.length, need);
+        return BVAL(false);
+    }
+    return BVAL(eng_texture_update(g_r, id, ARG_INT(1), ARG_INT(2), w, h, args[5].string.data));
+}
+static Value fn_テクスチャ一括読込(int argc, Value* args) {
+    /* パス配列 → ID 配列 (失敗した要素は 0) */
+    if (argc < 1 || args[0].type != VALUE_ARRAY) return NUL;
+    int n = args[0].array.length;
+    const char** paths = (const char**)calloc((size_t)(n > 0 ? n : 1), sizeof(char*));
+    ENG_TexID*   ids   = (ENG_TexID*)calloc((size_t)(n > 0 ? n : 1), sizeof(ENG_TexID));
+    Value out = make_array(n);
+    if (paths && ids && out.type == VALUE_ARRAY) {
+        for (int i = 0; i < n; ++i) {
+            const Value* a = &args[0].array.elements[i];
+            paths[i] = a->type == VALUE_STRING ? a->string.data : NULL;
+        }
+        eng_load_textures(g_r, paths, n, ids, NULL);
+        for (int i = 0; i < n; ++i) out.array.elements[i] = NUM(ids[i]);
+    }
+    free(paths);
+    free(ids);
+    return out;
+}
+/* パレット (INDEX8) */
+static Value fn_テクスチャパレット(int argc, Value* args) { return NUM(eng_tex_palette(g_r, (ENG_TexID)ARG_INT(0))); }
+static Value fn_パレット変種読込(int argc, Value* args)   { return NUM(eng_palette_load_variant(g_r, ARG_STR(0), ARG_STR(1))); }
+static Value fn_パレット削除(int argc, Value* args)       { eng_palette_free(g_r, (ENG_PaletteID)ARG_INT(0)); return NUL; }
+static Value fn_パレット設定(int argc, Value* args)       { eng_set_palette(g_r, (ENG_PaletteID)ARG_INT(0)); return NUL; }
+static Value fn_パレット色設定(int argc, Value* args) {
+    return BVAL(eng_palette_set_color(g_r, (ENG_PaletteID)ARG_INT(0), ARG_INT(1),
+                                      ARG_F(2), ARG_F(3), ARG_F(4), argc > 5 ? ARG_F(5) : 1.0f));
+}
+static Value fn_テクスチャVRAM(int argc, Value* args) { return NUM(eng_tex_vram_bytes(g_r, (ENG_TexID)ARG_INT(0))); }
+
+/* ================================================================
+ * アセットパック
+ * ================================================================ */
+static Value fn_パック開く(int argc, Value* args)         { return NUM(eng_pack_open(g_r, ARG_STR(0))); }
+static Value fn_パック閉じる(int argc, Value* args)       { eng_pack_close(g_r, (ENG_PackID)ARG_INT(0)); return NUL; }
+static Value fn_パック存在(int argc, Value* args)         { return BVAL(eng_pack_contains(g_r, (ENG_PackID)ARG_INT(0), ARG_STR(1))); }
+static Value fn_パックテクスチャ読込(int argc, Value* args) { return NUM(eng_pack_load_texture(g_r, (ENG_PackID)ARG_INT(0), ARG_STR(1))); }
+static Value fn_パックフォント読込(int argc, Value* args) {
+    return NUM(eng_pack_load_font(g_r, (ENG_PackID)ARG_INT(0), ARG_STR(1), ARG_F(2)));
+}
 
 /* ================================================================
  * スプライト
@@ -195,6 +362,9 @@ static Value fn_直線描画(int argc, Value* args) {
 static Value fn_フォント読込(int argc, Value* args) {
     return NUM(eng_load_font(g_r, ARG_STR(0), ARG_F(1)));
 }
+static Value fn_SDFフォント読込(int argc, Value* args) {
+    return NUM(eng_load_font_sdf(g_r, ARG_STR(0), ARG_F(1)));
+}
 static Value fn_フォント読込デフォルト(int argc, Value* args) {
     return NUM(eng_load_font_default(g_r, argc > 0 ? ARG_F(0) : 24.0f));
 }
@@ -202,6 +372,27 @@ static Value fn_フォント削除(int argc, Value* args) {
     eng_free_font(g_r, (ENG_FontID)ARG_INT(0));
     return NUL;
 }
+static Value fn_フェイス読込(int argc, Value* args) {
+    return NUM(eng_load_face(g_r, ARG_STR(0)));
+}
+static Value fn_フェイスからフォント(int argc, Value* args) {
+    return NUM(eng_font_from_face(g_r, (ENG_FaceID)ARG_INT(0), ARG_F(1)));
+}
+static Value fn_フェイスからSDFフォント(int argc, Value* args) {
+    return NUM(eng_font_from_face_sdf(g_r, (ENG_FaceID)ARG_INT(0), ARG_F(1)));
+}
+static Value fn_フェイス削除(int argc, Value* args) {
+    eng_free_face(g_r, (ENG_FaceID)ARG_INT(0));
+    return NUL;
+}
+static Value fn_フォントキャッシュ設定(int argc, Value* args) {
+    eng_set_font_cache_dir(g_r, ARG_STR(0));
+    return NUL;
+}
+static Value fn_グリフ非同期設定(int argc, Value* args) {
+    eng_set_async_glyphs(g_r, ARG_INT(0));
+    return NUL;
+}
 static Value fn_テキスト描画(int argc, Value* args) {
     float cr = argc > 4 ? ARG_F(4) : 1.0f;
     float cg = argc > 5 ? ARG_F(5) : 1.0f;
@@ -211,6 +402,17 @@ static Value fn_テキスト描画(int argc, Value* args) {
                   ARG_F(2), ARG_F(3), cr, cg, cb, ca);
     return NUL;
 }
+static Value fn_テキスト描画拡張(int argc, Value* args) {
+    /* (id, 文字列, x, y, サイズ[, 角度, r, g, b, a]) */
+    float rot = argc > 5 ? ARG_F(5) : 0.0f;
+    float cr  = argc > 6 ? ARG_F(6) : 1.0f;
+    float cg  = argc > 7 ? ARG_F(7) : 1.0f;
+    float cb  = argc > 8 ? ARG_F(8) : 1.0f;
+    float ca  = argc > 9 ? ARG_F(9) : 1.0f;
+    eng_draw_text_ex(g_r, (ENG_FontID)ARG_INT(0), ARG_STR(1),
+                     ARG_F(2), ARG_F(3), ARG_F(4), rot, cr, cg, cb, ca);
+    return NUL;
+}
 static Value fn_テキスト幅(int argc, Value* args) {
     return NUM(eng_text_width(g_r, (ENG_FontID)ARG_INT(0), ARG_STR(1)));
 }
@@ -218,6 +420,43 @@ static Value fn_テキスト高さ(int argc, Value* args) {
     return NUM(eng_text_height(g_r, (ENG_FontID)ARG_INT(0)));
 }
 
+/* テキストレイアウト: 揃えは "左" / "中央" / "右" */
+static Value fn_テキストレイアウト作成(int argc, Value* args) {
+    ENG_TextAlign align = ENG_ALIGN_LEFT;
+    if (argc > 3) {
+        const char* a = ARG_STR(3);
+        if (strcmp(a, "中央") == 0)    align = ENG_ALIGN_CENTER;
+        else if (strcmp(a, "右") == 0) align = ENG_ALIGN_RIGHT;
+    }
+    return NUM(eng_text_layout_create(g_r, (ENG_FontID)ARG_INT(0), ARG_STR(1),
+                                      argc > 2 ? ARG_F(2) : 0.0f, align));
+}
+static Value fn_テキストレイアウト更新(int argc, Value* args) {
+    return BVAL(eng_text_layout_set_text(g_r, (ENG_TextID)ARG_INT(0), ARG_STR(1)));
+}
+static Value fn_テキストレイアウト描画(int argc, Value* args) {
+    float cr = argc > 3 ? ARG_F(3) : 1.0f;
+    float cg = argc > 4 ? ARG_F(4) : 1.0f;
+    float cb = argc > 5 ? ARG_F(5) : 1.0f;
+    float ca = argc > 6 ? ARG_F(6) : 1.0f;
+    eng_text_layout_draw(g_r, (ENG_TextID)ARG_INT(0), ARG_F(1), ARG_F(2), cr, cg, cb, ca);
+    return NUL;
+}
+static Value fn_テキストレイアウト幅(int argc, Value* args) {
+    float w;
+    eng_text_layout_size(g_r, (ENG_TextID)ARG_INT(0), &w, NULL);
+    return NUM(w);
+}
+static Value fn_テキストレイアウト高さ(int argc, Value* args) {
+    float h;
+    eng_text_layout_size(g_r, (ENG_TextID)ARG_INT(0), NULL, &h);
+    return NUM(h);
+}
+static Value fn_テキストレイアウト削除(int argc, Value* args) {
+    eng_text_layout_free(g_r, (ENG_TextID)ARG_INT(0));
+    return NUL;
+}
+
 /* ================================================================
  * ウィンドウ設定 (v1.2.0)
  * ================================================================ */
@@ -269,6 +508,72 @@ static Value fn_ワールド変換スクリーン(int argc, Value* args) {
     snprintf(buf, sizeof(buf), "%g,%g", (double)sx, (double)sy);
     return STR(buf);
 }
+/* 座標は [x, y] の数値配列で返す (文字列の組み立て・解析をしない) */
+static Value point_array(float x, float y) {
+    Value out = make_array(2);
+    if (out.type == VALUE_ARRAY) {
+        out.array.elements[0] = NUM(x);
+        out.array.elements[1] = NUM(y);
+    }
+    return out;
+}
+static Value fn_スクリーン変換ワールド座標(int argc, Value* args) {
+    float wx, wy;
+    eng_cam_screen_to_world(g_r, ARG_F(0), ARG_F(1), &wx, &wy);
+    return point_array(wx, wy);
+}
+static Value fn_ワールド変換スクリーン座標(int argc, Value* args) {
+    float sx, sy;
+    eng_cam_world_to_screen(g_r, ARG_F(0), ARG_F(1), &sx, &sy);
+    return point_array(sx, sy);
+}
+/* [x0, y0, x1, y1, ...] → 同じ並びの配列 */
+static Value transform_array(int argc, Value* args, ENG_CamDir dir) {
+    if (argc < 1 || args[0].type != VALUE_ARRAY) return NUL;
+    int    n   = args[0].array.length / 2;
+    float* buf = (float*)malloc((size_t)(n > 0 ? n : 1) * 2 * sizeof(float));
+    Value  out = make_array(n * 2);
+    if (buf && out.type == VALUE_ARRAY) {
+        const Value* el = args[0].array.elements;
+        for (int i = 0; i < n * 2; ++i) buf[i] = el[i].type == VALUE_NUMBER ? (float)el[i].number : 0.0f;
+        eng_cam_transform_points(g_r, buf, buf, n, dir);
+        for (int i = 0; i < n * 2; ++i) out.array.elements[i] = NUM(buf[i]);
+    }
+    free(buf);
+    return out;
+}
+static Value fn_スクリーン変換ワールド一括(int argc, Value* args) {
+    return transform_array(argc, args, ENG_CAM_SCREEN_TO_WORLD);
+}
+static Value fn_ワールド変換スクリーン一括(int argc, Value* args) {
+    return transform_array(argc, args, ENG_CAM_WORLD_TO_SCREEN);
+}
+static Value fn_解像度倍率設定(int argc, Value* args) { eng_set_render_scale(g_r, ARG_F(0)); return NUL; }
+static Value fn_解像度自動調整(int argc, Value* args) {
+    eng_set_render_scale_auto(g_r, ARG_F(0), argc > 1 ? ARG_F(1) : 0.5f, argc > 2 ? ARG_F(2) : 1.0f);
+    return NUL;
+}
+static Value fn_解像度拡大ドット(int argc, Value* args) { eng_set_render_scale_nearest(g_r, ARG_B(0)); return NUL; }
+static Value fn_解像度倍率取得(int argc, Value* args)   { (void)argc; (void)args; return NUM(eng_render_scale(g_r)); }
+static Value fn_GPU時間取得(int argc, Value* args)      { (void)argc; (void)args; return NUM(eng_render_gpu_ms(g_r)); }
+static Value fn_UI描画開始(int argc, Value* args)       { (void)argc; (void)args; eng_begin_ui(g_r); return NUL; }
+static Value fn_ビューポート設定(int argc, Value* args) {
+    return BVAL(eng_viewport_set(g_r, ARG_INT(0), ARG_F(1), ARG_F(2), ARG_F(3), ARG_F(4)));
+}
+static Value fn_ビューポートカメラ(int argc, Value* args) {
+    eng_viewport_cam(g_r, ARG_INT(0), ARG_F(1), ARG_F(2),
+                     argc > 3 ? ARG_F(3) : 1.0f, argc > 4 ? ARG_F(4) : 0.0f);
+    return NUL;
+}
+static Value fn_ビューポート解除(int argc, Value* args)     { (void)argc; (void)args; eng_viewport_clear(g_r); return NUL; }
+static Value fn_ビューポート描画開始(int argc, Value* args) { (void)argc; (void)args; eng_viewport_begin(g_r); return NUL; }
+static Value fn_ビューポート描画終了(int argc, Value* args) { (void)argc; (void)args; eng_viewport_end(g_r); return NUL; }
+static Value fn_ビューポート番号(int argc, Value* args)     { return NUM(eng_viewport_at(g_r, ARG_F(0), ARG_F(1))); }
+static Value fn_ビューポートワールド座標(int argc, Value* args) {
+    float wx, wy;
+    if (!eng_viewport_screen_to_world(g_r, ARG_INT(0), ARG_F(1), ARG_F(2), &wx, &wy)) return NUL;
+    return point_array(wx, wy);
+}
 static Value fn_テキスト折返し描画(int argc, Value* args) {
     float cr = argc>5?ARG_F(5):1, cg = argc>6?ARG_F(6):1,
           cb = argc>7?ARG_F(7):1, ca_v = argc>8?ARG_F(8):1;
@@ -277,6 +582,16 @@ static Value fn_テキスト折返し描画(int argc, Value* args) {
                        cr, cg, cb, ca_v);
     return NUL;
 }
+static Value fn_テキスト折返し幅(int argc, Value* args) {
+    float w;
+    eng_text_measure(g_r, (ENG_FontID)ARG_INT(0), ARG_STR(1), ARG_F(2), &w, NULL);
+    return NUM(w);
+}
+static Value fn_テキスト折返し高さ(int argc, Value* args) {
+    float h;
+    eng_text_measure(g_r, (ENG_FontID)ARG_INT(0), ARG_STR(1), ARG_F(2), NULL, &h);
+    return NUM(h);
+}
 
 /* ================================================================
  * プラグイン登録
@@ -307,14 +622,48 @@ static HajimuPluginFunc funcs[] = {
     FN(マウスホイール,   0, 0),
     FN(キーコード,         1, 1),
     FN(FPS上限設定,     1, 1),
+    FN(ペーシング設定,   1, 1),
+    FN(垂直同期設定,     1, 1),
+    FN(フレーム統計,     1, 1),
+    FN(固定ステップ設定, 1, 2),
+    FN(固定ステップ数,   0, 0),
+    FN(固定ステップ秒,   0, 0),
+    FN(補間係数,         0, 0),
     /* 描画基本 */
     FN(描画クリア,   0, 4),
     FN(描画フラッシュ, 0, 0),
+    FN(乗算済みアルファ設定, 1, 1),
+    FN(加算合成,             1, 1),
     /* テクスチャ */
     FN(テクスチャ読込, 1, 1),
     FN(テクスチャ削除, 1, 1),
     FN(テクスチャ幅,   1, 1),
     FN(テクスチャ高さ, 1, 1),
+    FN(テクスチャ非同期読込, 1, 1),
+    FN(テクスチャ読込完了,   1, 1),
+    FN(テクスチャ読込中件数, 0, 0),
+    FN(転送予算設定,         1, 1),
+    FN(アトラス設定,         1, 1),
+    FN(テクスチャ予算設定,   1, 1),
+    FN(テクスチャ統計,       1, 1),
+    FN(テクスチャ形式読込,   2, 3),
+    FN(テクスチャ一括読込,   1, 1),
+    FN(テクスチャ形式,       1, 1),
+    FN(テクスチャVRAM,       1, 1),
+    FN(テクスチャ読込設定,   3, 5),
+    FN(テクスチャ作成,       2, 3),
+    FN(テクスチャ更新,       6, 6),
+    FN(テクスチャパレット,   1, 1),
+    FN(パレット変種読込,     2, 2),
+    FN(パレット色設定,       5, 6),
+    FN(パレット削除,         1, 1),
+    FN(パレット設定,         1, 1),
+    /* アセットパック */
+    FN(パック開く,           1, 1),
+    FN(パック閉じる,         1, 1),
+    FN(パック存在,           2, 2),
+    FN(パックテクスチャ読込, 2, 2),
+    FN(パックフォント読込,   3, 3),
     /* スプライト */
     FN(スプライト描画,     5, 5),
     FN(スプライト描画拡張, 5, 12),
@@ -333,11 +682,25 @@ static HajimuPluginFunc funcs[] = {
     FN(三角形塗潰, 6, 10),
     /* フォント */
     FN(フォント読込,         2, 2),
+    FN(SDFフォント読込,      2, 2),
     FN(フォント読込デフォルト, 0, 1),
     FN(フォント削除,         1, 1),
+    FN(フェイス読込,         1, 1),
+    FN(フェイスからフォント,   2, 2),
+    FN(フェイスからSDFフォント, 2, 2),
+    FN(フェイス削除,         1, 1),
+    FN(フォントキャッシュ設定, 1, 1),
+    FN(グリフ非同期設定,     1, 1),
     FN(テキスト描画,         4, 8),
+    FN(テキスト描画拡張,     5, 10),
     FN(テキスト幅,           2, 2),
     FN(テキスト高さ,         1, 1),
+    FN(テキストレイアウト作成, 2, 4),
+    FN(テキストレイアウト更新, 2, 2),
+    FN(テキストレイアウト描画, 3, 7),
+    FN(テキストレイアウト幅,   1, 1),
+    FN(テキストレイアウト高さ, 1, 1),
+    FN(テキストレイアウト削除, 1, 1),
     /* カメラ */
     FN(カメラ位置設定,   2, 2),
     FN(カメラズーム設定, 1, 1),
@@ -354,7 +717,28 @@ static HajimuPluginFunc funcs[] = {
     FN(ウィンドウタイトル設定,    1, 1),
     FN(スクリーン変換ワールド,    2, 2),
     FN(ワールド変換スクリーン,    2, 2),
+    FN(スクリーン変換ワールド座標, 2, 2),
+    FN(ワールド変換スクリーン座標, 2, 2),
+    FN(スクリーン変換ワールド一括, 1, 1),
+    FN(ワールド変換スクリーン一括, 1, 1),
+    /* 解像度スケール */
+    FN(解像度倍率設定,   1, 1),
+    FN(解像度自動調整,   1, 3),
+    FN(解像度拡大ドット, 1, 1),
+    FN(解像度倍率取得,   0, 0),
+    FN(GPU時間取得,      0, 0),
+    FN(UI描画開始,       0, 0),
+    /* ビューポート (画面分割) */
+    FN(ビューポート設定,         5, 5),
+    FN(ビューポートカメラ,       3, 5),
+    FN(ビューポート解除,         0, 0),
+    FN(ビューポート描画開始,     0, 0),
+    FN(ビューポート描画終了,     0, 0),
+    FN(ビューポート番号,         2, 2),
+    FN(ビューポートワールド座標, 3, 3),
     FN(テキスト折返し描画,        5, 9),
+    FN(テキスト折返し幅,          3, 3),
+    FN(テキスト折返し高さ,        3, 3),
 };
 
 HAJIMU_PLUGIN_EXPORT HajimuPluginInfo* hajimu_plugin_init(void) {
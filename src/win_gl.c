@@ -19,6 +19,7 @@ PFNGLBINDVERTEXARRAYPROC          pfn_glBindVertexArray;
 PFNGLBUFFERDATAPROC               pfn_glBufferData;
 PFNGLBUFFERSUBDATAPROC            pfn_glBufferSubData;
 PFNGLCOMPILESHADERPROC            pfn_glCompileShader;
+PFNGLCOMPRESSEDTEXIMAGE2DPROC     pfn_glCompressedTexImage2D;
 PFNGLCREATEPROGRAMPROC            pfn_glCreateProgram;
 PFNGLCREATESHADERPROC             pfn_glCreateShader;
 PFNGLDELETEBUFFERSPROC            pfn_glDeleteBuffers;
@@ -32,6 +33,7 @@ PFNGLGETPROGRAMINFOLOGPROC        pfn_glGetProgramInfoLog;
 PFNGLGETPROGRAMIVPROC             pfn_glGetProgramiv;
 PFNGLGETSHADERINFOLOGPROC         pfn_glGetShaderInfoLog;
 PFNGLGETSHADERIVPROC              pfn_glGetShaderiv;
+PFNGLGETSTRINGIPROC               pfn_glGetStringi;
 PFNGLGETUNIFORMLOCATIONPROC       pfn_glGetUniformLocation;
 PFNGLLINKPROGRAMPROC              pfn_glLinkProgram;
 PFNGLSHADERSOURCEPROC             pfn_glShaderSource;
@@ -39,6 +41,29 @@ PFNGLUSEPROGRAMPROC               pfn_glUseProgram;
 PFNGLVERTEXATTRIBPOINTERPROC      pfn_glVertexAttribPointer;
 PFNGLUNIFORMMATRIX4FVPROC         pfn_glUniformMatrix4fv;
 PFNGLUNIFORM1IPROC                pfn_glUniform1i;
+PFNGLBINDSAMPLERPROC              pfn_glBindSampler;
+PFNGLDELETESAMPLERSPROC           pfn_glDeleteSamplers;
+PFNGLGENSAMPLERSPROC              pfn_glGenSamplers;
+PFNGLGENERATEMIPMAPPROC           pfn_glGenerateMipmap;
+PFNGLSAMPLERPARAMETERIPROC        pfn_glSamplerParameteri;
+PFNGLMAPBUFFERRANGEPROC           pfn_glMapBufferRange;
+PFNGLUNMAPBUFFERPROC              pfn_glUnmapBuffer;
+PFNGLFENCESYNCPROC                pfn_glFenceSync;
+PFNGLCLIENTWAITSYNCPROC           pfn_glClientWaitSync;
+PFNGLDELETESYNCPROC               pfn_glDeleteSync;
+PFNGLDRAWELEMENTSBASEVERTEXPROC   pfn_glDrawElementsBaseVertex;
+PFNGLGENFRAMEBUFFERSPROC          pfn_glGenFramebuffers;
+PFNGLBINDFRAMEBUFFERPROC          pfn_glBindFramebuffer;
+PFNGLFRAMEBUFFERTEXTURE2DPROC     pfn_glFramebufferTexture2D;
+PFNGLCHECKFRAMEBUFFERSTATUSPROC   pfn_glCheckFramebufferStatus;
+PFNGLDELETEFRAMEBUFFERSPROC       pfn_glDeleteFramebuffers;
+PFNGLBLITFRAMEBUFFERPROC          pfn_glBlitFramebuffer;
+PFNGLGENQUERIESPROC               pfn_glGenQueries;
+PFNGLDELETEQUERIESPROC            pfn_glDeleteQueries;
+PFNGLBEGINQUERYPROC               pfn_glBeginQuery;
+PFNGLENDQUERYPROC                 pfn_glEndQuery;
+PFNGLGETQUERYOBJECTIVPROC         pfn_glGetQueryObjectiv;
+PFNGLGETQUERYOBJECTUI64VPROC      pfn_glGetQueryObjectui64v;
 
 /* ── ローダー ──────────────────────────────────────*/
 #define LOAD(var, name) \
@@ -55,6 +80,7 @@ int win_gl_load(void) {
     LOAD(pfn_glBufferData,              "glBufferData")
     LOAD(pfn_glBufferSubData,           "glBufferSubData")
     LOAD(pfn_glCompileShader,           "glCompileShader")
+    LOAD(pfn_glCompressedTexImage2D,    "glCompressedTexImage2D")
     LOAD(pfn_glCreateProgram,           "glCreateProgram")
     LOAD(pfn_glCreateShader,            "glCreateShader")
     LOAD(pfn_glDeleteBuffers,           "glDeleteBuffers")
@@ -68,6 +94,7 @@ int win_gl_load(void) {
     LOAD(pfn_glGetProgramiv,            "glGetProgramiv")
     LOAD(pfn_glGetShaderInfoLog,        "glGetShaderInfoLog")
     LOAD(pfn_glGetShaderiv,             "glGetShaderiv")
+    LOAD(pfn_glGetStringi,              "glGetStringi")
     LOAD(pfn_glGetUniformLocation,      "glGetUniformLocation")
     LOAD(pfn_glLinkProgram,             "glLinkProgram")
     LOAD(pfn_glShaderSource,            "glShaderSource")
@@ -75,6 +102,29 @@ int win_gl_load(void) {
     LOAD(pfn_glVertexAttribPointer,     "glVertexAttribPointer")
     LOAD(pfn_glUniformMatrix4fv,        "glUniformMatrix4fv")
     LOAD(pfn_glUniform1i,               "glUniform1i")
+    LOAD(pfn_glBindSampler,             "glBindSampler")
+    LOAD(pfn_glDeleteSamplers,          "glDeleteSamplers")
+    LOAD(pfn_glGenSamplers,             "glGenSamplers")
+    LOAD(pfn_glGenerateMipmap,          "glGenerateMipmap")
+    LOAD(pfn_glSamplerParameteri,       "glSamplerParameteri")
+    LOAD(pfn_glMapBufferRange,          "glMapBufferRange")
+    LOAD(pfn_glUnmapBuffer,             "glUnmapBuffer")
+    LOAD(pfn_glFenceSync,               "glFenceSync")
+    LOAD(pfn_glClientWaitSync,          "glClientWaitSync")
+    LOAD(pfn_glDeleteSync,              "glDeleteSync")
+    LOAD(pfn_glDrawElementsBaseVertex,  "glDrawElementsBaseVertex")
+    LOAD(pfn_glGenFramebuffers,         "glGenFramebuffers")
+    LOAD(pfn_glBindFramebuffer,         "glBindFramebuffer")
+    LOAD(pfn_glFramebufferTexture2D,    "glFramebufferTexture2D")
+    LOAD(pfn_glCheckFramebufferStatus,  "glCheckFramebufferStatus")
+    LOAD(pfn_glDeleteFramebuffers,      "glDeleteFramebuffers")
+    LOAD(pfn_glBlitFramebuffer,         "glBlitFramebuffer")
+    LOAD(pfn_glGenQueries,              "glGenQueries")
+    LOAD(pfn_glDeleteQueries,           "glDeleteQueries")
+    LOAD(pfn_glBeginQuery,              "glBeginQuery")
+    LOAD(pfn_glEndQuery,                "glEndQuery")
+    LOAD(pfn_glGetQueryObjectiv,        "glGetQueryObjectiv")
+    LOAD(pfn_glGetQueryObjectui64v,     "glGetQueryObjectui64v")
     return 1;
 }
 
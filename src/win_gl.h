@@ -17,6 +17,7 @@ extern PFNGLBINDVERTEXARRAYPROC          pfn_glBindVertexArray;
 extern PFNGLBUFFERDATAPROC               pfn_glBufferData;
 extern PFNGLBUFFERSUBDATAPROC            pfn_glBufferSubData;
 extern PFNGLCOMPILESHADERPROC            pfn_glCompileShader;
+extern PFNGLCOMPRESSEDTEXIMAGE2DPROC     pfn_glCompressedTexImage2D;
 extern PFNGLCREATEPROGRAMPROC            pfn_glCreateProgram;
 extern PFNGLCREATESHADERPROC             pfn_glCreateShader;
 extern PFNGLDELETEBUFFERSPROC            pfn_glDeleteBuffers;
@@ -30,6 +31,7 @@ extern PFNGLGETPROGRAMINFOLOGPROC        pfn_glGetProgramInfoLog;
 extern PFNGLGETPROGRAMIVPROC             pfn_glGetProgramiv;
 extern PFNGLGETSHADERINFOLOGPROC         pfn_glGetShaderInfoLog;
 extern PFNGLGETSHADERIVPROC              pfn_glGetShaderiv;
+extern PFNGLGETSTRINGIPROC               pfn_glGetStringi;
 extern PFNGLGETUNIFORMLOCATIONPROC       pfn_glGetUniformLocation;
 extern PFNGLLINKPROGRAMPROC              pfn_glLinkProgram;
 extern PFNGLSHADERSOURCEPROC             pfn_glShaderSource;
@@ -37,6 +39,29 @@ extern PFNGLUSEPROGRAMPROC               pfn_glUseProgram;
 extern PFNGLVERTEXATTRIBPOINTERPROC      pfn_glVertexAttribPointer;
 extern PFNGLUNIFORMMATRIX4FVPROC         pfn_glUniformMatrix4fv;
 extern PFNGLUNIFORM1IPROC                pfn_glUniform1i;
+extern PFNGLBINDSAMPLERPROC             pfn_glBindSampler;
+extern PFNGLDELETESAMPLERSPROC          pfn_glDeleteSamplers;
+extern PFNGLGENSAMPLERSPROC             pfn_glGenSamplers;
+extern PFNGLGENERATEMIPMAPPROC          pfn_glGenerateMipmap;
+extern PFNGLSAMPLERPARAMETERIPROC       pfn_glSamplerParameteri;
+extern PFNGLMAPBUFFERRANGEPROC          pfn_glMapBufferRange;
+extern PFNGLUNMAPBUFFERPROC             pfn_glUnmapBuffer;
+extern PFNGLFENCESYNCPROC               pfn_glFenceSync;
+extern PFNGLCLIENTWAITSYNCPROC          pfn_glClientWaitSync;
+extern PFNGLDELETESYNCPROC              pfn_glDeleteSync;
+extern PFNGLDRAWELEMENTSBASEVERTEXPROC  pfn_glDrawElementsBaseVertex;
+extern PFNGLGENFRAMEBUFFERSPROC         pfn_glGenFramebuffers;
+extern PFNGLBINDFRAMEBUFFERPROC         pfn_glBindFramebuffer;
+extern PFNGLFRAMEBUFFERTEXTURE2DPROC    pfn_glFramebufferTexture2D;
+extern PFNGLCHECKFRAMEBUFFERSTATUSPROC  pfn_glCheckFramebufferStatus;
+extern PFNGLDELETEFRAMEBUFFERSPROC      pfn_glDeleteFramebuffers;
+extern PFNGLBLITFRAMEBUFFERPROC         pfn_glBlitFramebuffer;
+extern PFNGLGENQUERIESPROC              pfn_glGenQueries;
+extern PFNGLDELETEQUERIESPROC           pfn_glDeleteQueries;
+extern PFNGLBEGINQUERYPROC              pfn_glBeginQuery;
+extern PFNGLENDQUERYPROC                pfn_glEndQuery;
+extern PFNGLGETQUERYOBJECTIVPROC        pfn_glGetQueryObjectiv;
+extern PFNGLGETQUERYOBJECTUI64VPROC     pfn_glGetQueryObjectui64v;
 
 /* ── gl* → pfn_gl* マクロ置換 ────────────────────────*/
 #define glActiveTexture            pfn_glActiveTexture
@@ -46,6 +71,7 @@ extern PFNGLUNIFORM1IPROC                pfn_glUniform1i;
 #define glBufferData               pfn_glBufferData
 #define glBufferSubData            pfn_glBufferSubData
 #define glCompileShader            pfn_glCompileShader
+#define glCompressedTexImage2D     pfn_glCompressedTexImage2D
 #define glCreateProgram            pfn_glCreateProgram
 #define glCreateShader             pfn_glCreateShader
 #define glDeleteBuffers            pfn_glDeleteBuffers
@@ -59,6 +85,7 @@ extern PFNGLUNIFORM1IPROC                pfn_glUniform1i;
 #define glGetProgramiv             pfn_glGetProgramiv
 #define glGetShaderInfoLog         pfn_glGetShaderInfoLog
 #define glGetShaderiv              pfn_glGetShaderiv
+#define glGetStringi               pfn_glGetStringi
 #define glGetUniformLocation       pfn_glGetUniformLocation
 #define glLinkProgram              pfn_glLinkProgram
 #define glShaderSource             pfn_glShaderSource
@@ -66,6 +93,29 @@ extern PFNGLUNIFORM1IPROC                pfn_glUniform1i;
 #define glVertexAttribPointer      pfn_glVertexAttribPointer
 #define glUniformMatrix4fv         pfn_glUniformMatrix4fv
 #define glUniform1i                pfn_glUniform1i
+#define glBindSampler              pfn_glBindSampler
+#define glDeleteSamplers           pfn_glDeleteSamplers
+#define glGenSamplers              pfn_glGenSamplers
+#define glGenerateMipmap           pfn_glGenerateMipmap
+#define glSamplerParameteri        pfn_glSamplerParameteri
+#define glMapBufferRange           pfn_glMapBufferRange
+#define glUnmapBuffer              pfn_glUnmapBuffer
+#define glFenceSync                pfn_glFenceSync
+#define glClientWaitSync           pfn_glClientWaitSync
+#define glDeleteSync               pfn_glDeleteSync
+#define glDrawElementsBaseVertex   pfn_glDrawElementsBaseVertex
+#define glGenFramebuffers          pfn_glGenFramebuffers
+#define glBindFramebuffer          pfn_glBindFramebuffer
+#define glFramebufferTexture2D     pfn_glFramebufferTexture2D
+#define glCheckFramebufferStatus   pfn_glCheckFramebufferStatus
+#define glDeleteFramebuffers       pfn_glDeleteFramebuffers
+#define glBlitFramebuffer          pfn_glBlitFramebuffer
+#define glGenQueries               pfn_glGenQueries
+#define glDeleteQueries            pfn_glDeleteQueries
+#define glBeginQuery               pfn_glBeginQuery
+#define glEndQuery                 pfn_glEndQuery
+#define glGetQueryObjectiv         pfn_glGetQueryObjectiv
+#define glGetQueryObjectui64v      pfn_glGetQueryObjectui64v
 
 /* ── ローダー関数 ─────────────────────────────────────*/
 /** SDL_GL_CreateContext() 後に必ず呼ぶこと。
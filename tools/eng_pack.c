@@ -0,0 +1,266 @@
+/**
+ * tools/eng_pack.c — アセットパック (.hjpk) 作成ツール
+ *
+ * 使い方:
+ *   eng_pack 出力.hjpk 画像.png ... フォント.ttf@16,24 ...
+ *
+ *   画像     — stb_image でデコードし RGBA8 のまま格納
+ *   フォント — TTF 本体 + 指定サイズごとのベイク済みアトラス (ASCII 32〜127)
+ *
+ * エントリ名は引数に書いたパスそのまま (フォントのベイク済みは "名前@サイズ")。
+ * 実行時は eng_pack_open → eng_pack_load_texture / eng_pack_load_font で参照する。
+ */
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "stb_truetype.h"
+
+#include "eng_pack_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    char*          name;
+    uint32_t       type;
+    uint32_t       width, height;
+    unsigned char* data;  size_t data_size;
+    unsigned char* aux;   size_t aux_size;
+    float          font_size;
+    uint32_t       first_char;
+} Item;
+
+static Item*  g_items;
+static int    g_count, g_cap;
+
+static Item* push_item(const char* name) {
+    if (g_count == g_cap) {
+        g_cap = g_cap ? g_cap * 2 : 64;
+        g_items = (Item*)realloc(g_items, (size_t)g_cap * sizeof(Item));
+        if (!g_items) { fprintf(stderr, "メモリ不足\n"); exit(1); }
+    }
+    Item* it = &g_items[g_count++];
+    memset(it, 0, sizeof(*it));
+    size_t n = strlen(name);
+    it->name = (char*)malloc(n + 1);
+    memcpy(it->name, name, n + 1);
+    return it;
+}
+
+static unsigned char* read_file(const char* path, size_t* out_size) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long sz = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char* buf = (unsigned char*)malloc(sz > 0 ? (size_t)sz : 1);
+    if (buf && fread(buf, 1, (size_t)sz, f) != (size_t)sz) { free(buf); buf = NULL; }
+    fclose(f);
+    *out_size = (size_t)sz;
+    return buf;
+}
+
+/* ── 画像 ───────────────────────────────────────────────*/
+static int add_image(const char* path) {
+    int w, h, ch;
+    unsigned char* px = stbi_load(path, &w, &h, &ch, 4);
+    if (!px) {
+        fprintf(stderr, "画像読込失敗: %s — %s\n", path, stbi_failure_reason());
+        return 0;
+    }
+    Item* it = push_item(path);
+    it->type      = ENG_PACK_RGBA8;
+    it->width     = (uint32_t)w;
+    it->height    = (uint32_t)h;
+    it->data      = px;
+    it->data_size = (size_t)w * (size_t)h * 4;
+    return 1;
+}
+
+/* ── フォント ───────────────────────────────────────────*/
+static int bake_font(const char* name, const unsigned char* ttf, float size) {
+    /* 収まるまでアトラスを拡大する */
+    for (int dim = 512; dim <= 4096; dim *= 2) {
+        unsigned char* atlas = (unsigned char*)calloc((size_t)dim * (size_t)dim, 1);
+        stbtt_bakedchar* baked = (stbtt_bakedchar*)malloc(96 * sizeof(stbtt_bakedchar));
+        if (!atlas || !baked) { free(atlas); free(baked); return 0; }
+        if (stbtt_BakeFontBitmap(ttf, 0, size, atlas, dim, dim, 32, 96, baked) > 0) {
+            char ename[ENG_PACK_FONT_NAME_MAX];
+            int  n = snprintf(ename, sizeof(ename), ENG_PACK_FONT_NAME_FMT, name, (double)size);
+            if (n < 0 || (size_t)n >= sizeof(ename)) {
+                fprintf(stderr, "フォント名が長すぎます: %s\n", name);
+                free(atlas); free(baked);
+                return 0;
+            }
+            Item* it = push_item(ename);
+            it->type       = ENG_PACK_FONT_BAKED;
+            it->width      = (uint32_t)dim;
+            it->height     = (uint32_t)dim;
+            it->data       = atlas;
+            it->data_size  = (size_t)dim * (size_t)dim;
+            it->aux        = (unsigned char*)baked;
+            it->aux_size   = 96 * sizeof(ENG_PackGlyph);
+            it->font_size  = size;
+            it->first_char = 32;
+            return 1;
+        }
+        free(atlas); free(baked);
+    }
+    fprintf(stderr, "フォントベイク失敗: %s @ %g\n", name, (double)size);
+    return 0;
+}
+
+static int add_font(const char* arg) {
+    char path[ENG_PACK_FONT_NAME_MAX];
+    int  len = snprintf(path, sizeof(path), "%s", arg);
+    if (len < 0 || (size_t)len >= sizeof(path)) {
+        fprintf(stderr, "フォントのパスが長すぎます: %s\n", arg);
+        return 0;
+    }
+    char* sizes = strchr(path, '@');
+    if (sizes) *sizes++ = '\0';
+
+    size_t n;
+    unsigned char* ttf = read_file(path, &n);
+    if (!ttf) { fprintf(stderr, "フォント読込失敗: %s\n", path); return 0; }
+
+    Item* it = push_item(path);
+    it->type      = ENG_PACK_FONT_TTF;
+    it->data      = ttf;
+    it->data_size = n;
+
+    int ok = 1;
+    while (sizes && *sizes) {
+        float sz = strtof(sizes, &sizes);
+        if (sz > 0.0f) ok &= bake_font(path, ttf, sz);
+        while (*sizes == ',' || *sizes == ' ') ++sizes;
+    }
+    return ok;
+}
+
+static int is_font(const char* arg) {
+    const char* at = strchr(arg, '@');
+    size_t      n  = at ? (size_t)(at - arg) : strlen(arg);
+    if (n <= 4) return 0;
+    const char* ext = arg + n - 4;
+    return strncmp(ext, ".ttf", 4) == 0 || strncmp(ext, ".otf", 4) == 0 ||
+           strncmp(ext, ".TTF", 4) == 0 || strncmp(ext, ".OTF", 4) == 0;
+}
+
+/* ── 書き出し ───────────────────────────────────────────*/
+static uint64_t align_up(uint64_t v) {
+    return (v + ENG_PACK_ALIGN - 1) & ~(uint64_t)(ENG_PACK_ALIGN - 1);
+}
+
+static void write_pad(FILE* f, uint64_t* pos, uint64_t target) {
+    static const unsigned char zero[ENG_PACK_ALIGN];
+    while (*pos < target) {
+        uint64_t n = target - *pos;
+        if (n > ENG_PACK_ALIGN) n = ENG_PACK_ALIGN;
+        fwrite(zero, 1, (size_t)n, f);
+        *pos += n;
+    }
+}
+
+static int write_pack(const char* out) {
+    uint32_t buckets = 16;
+    while (buckets < (uint32_t)g_count * 2) buckets <<= 1;  /* 負荷率 ≤ 0.5 */
+
+    ENG_PackEntry* ents = (ENG_PackEntry*)calloc((size_t)g_count + 1, sizeof(ENG_PackEntry));
+    uint32_t*      tab  = (uint32_t*)calloc(buckets, sizeof(uint32_t));
+    if (!ents || !tab) return 0;
+
+    size_t names_size = 0;
+    for (int i = 0; i < g_count; ++i) names_size += strlen(g_items[i].name) + 1;
+
+    ENG_PackHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.magic          = ENG_PACK_MAGIC;
+    hdr.version        = ENG_PACK_VERSION;
+    hdr.entry_count    = (uint32_t)g_count;
+    hdr.bucket_count   = buckets;
+    hdr.entries_offset = sizeof(ENG_PackHeader);
+    hdr.buckets_offset = hdr.entries_offset + (uint64_t)g_count * sizeof(ENG_PackEntry);
+    hdr.names_offset   = hdr.buckets_offset + (uint64_t)buckets * sizeof(uint32_t);
+
+    uint64_t pos = align_up(hdr.names_offset + names_size);
+    uint32_t name_off = 0;
+    for (int i = 0; i < g_count; ++i) {
+        Item* it = &g_items[i];
+        ENG_PackEntry* e = &ents[i];
+        e->name_hash   = eng_pack_hash(it->name);
+        e->name_offset = name_off;
+        e->type        = it->type;
+        e->width       = it->width;
+        e->height      = it->height;
+        e->font_size   = it->font_size;
+        e->first_char  = it->first_char;
+        e->data_offset = pos;
+        e->data_size   = it->data_size;
+        pos = align_up(pos + it->data_size);
+        if (it->aux_size) {
+            e->aux_offset = pos;
+            e->aux_size   = it->aux_size;
+            pos = align_up(pos + it->aux_size);
+        }
+        name_off += (uint32_t)strlen(it->name) + 1;
+
+        uint32_t b = (uint32_t)e->name_hash & (buckets - 1);
+        while (tab[b]) {
+            const Item* o = &g_items[tab[b] - 1];
+            if (strcmp(o->name, it->name) == 0) {
+                fprintf(stderr, "エントリ名が重複しています: %s\n", it->name);
+                return 0;
+            }
+            b = (b + 1) & (buckets - 1);
+        }
+        tab[b] = (uint32_t)i + 1;
+    }
+    hdr.file_size = pos;
+
+    FILE* f = fopen(out, "wb");
+    if (!f) { fprintf(stderr, "書き込み失敗: %s\n", out); return 0; }
+    uint64_t wpos = 0;
+    fwrite(&hdr, sizeof(hdr), 1, f);                       wpos += sizeof(hdr);
+    fwrite(ents, sizeof(ENG_PackEntry), (size_t)g_count, f); wpos += (uint64_t)g_count * sizeof(ENG_PackEntry);
+    fwrite(tab, sizeof(uint32_t), buckets, f);              wpos += (uint64_t)buckets * sizeof(uint32_t);
+    for (int i = 0; i < g_count; ++i) {
+        size_t n = strlen(g_items[i].name) + 1;
+        fwrite(g_items[i].name, 1, n, f);
+        wpos += n;
+    }
+    for (int i = 0; i < g_count; ++i) {
+        write_pad(f, &wpos, ents[i].data_offset);
+        fwrite(g_items[i].data, 1, g_items[i].data_size, f);
+        wpos += g_items[i].data_size;
+        if (ents[i].aux_size) {
+            write_pad(f, &wpos, ents[i].aux_offset);
+            fwrite(g_items[i].aux, 1, g_items[i].aux_size, f);
+            wpos += g_items[i].aux_size;
+        }
+    }
+    write_pad(f, &wpos, hdr.file_size);
+    int ok = ferror(f) == 0;
+    fclose(f);
+    free(ents);
+    free(tab);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        fprintf(stderr, "使い方: %s 出力.hjpk 画像.png ... フォント.ttf@16,24 ...\n", argv[0]);
+        return 2;
+    }
+    int ok = 1;
+    for (int i = 2; i < argc; ++i) {
+        ok &= is_font(argv[i]) ? add_font(argv[i]) : add_image(argv[i]);
+    }
+    if (!ok) return 1;
+    if (!write_pack(argv[1])) return 1;
+
+    uint64_t total = 0;
+    for (int i = 0; i < g_count; ++i) total += g_items[i].data_size + g_items[i].aux_size;
+    printf("%s: %d エントリ, %.1f MB\n", argv[1], g_count, (double)total / (1024.0 * 1024.0));
+    return 0;
+}
@@ -0,0 +1,204 @@
+/**
+ * tools/eng_texconv.c — 画像を高速デコード形式 (QOI / HJLZ) に変換するツール
+ *
+ * 使い方:
+ *   eng_texconv qoi 画像.png ...   → 画像.qoi  (可逆, PNG と同程度のサイズ)
+ *   eng_texconv lz4 画像.png ...   → 画像.hjlz (RGBA8 を LZ4 圧縮, 展開が最速)
+ *
+ * 出力は入力の拡張子を置き換えたパス。実行時は eng_load_texture が
+ * 先頭のマジックで判別するので、スクリプト側はパスを変えるだけでよい。
+ * 形式は src/eng_codec_format.h。
+ */
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include "eng_codec_format.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ── QOI エンコード ─────────────────────────────────────*/
+static unsigned char* encode_qoi(const unsigned char* px, int w, int h, size_t* out_size) {
+    size_t npx = (size_t)w * (size_t)h;
+    size_t cap = ENG_QOI_HEADER_SIZE + npx * 5 + ENG_QOI_END_SIZE;  /* 最悪ケース */
+    unsigned char* out = (unsigned char*)malloc(cap);
+    if (!out) return NULL;
+    unsigned char* o = out;
+
+    memcpy(o, ENG_QOI_MAGIC, 4);
+    for (int i = 0; i < 4; ++i) o[4 + i] = (unsigned char)((uint32_t)w >> (24 - 8 * i));
+    for (int i = 0; i < 4; ++i) o[8 + i] = (unsigned char)((uint32_t)h >> (24 - 8 * i));
+    o[12] = 4;  /* RGBA */
+    o[13] = 0;  /* sRGB + 線形アルファ */
+    o += ENG_QOI_HEADER_SIZE;
+
+    unsigned char index[64][4];
+    unsigned char prev[4] = { 0, 0, 0, 255 };
+    int run = 0;
+    memset(index, 0, sizeof(index));
+
+    for (size_t i = 0; i < npx; ++i) {
+        const unsigned char* c = px + i * 4;
+        if (memcmp(c, prev, 4) == 0) {
+            if (++run == 62 || i == npx - 1) { *o++ = (unsigned char)(ENG_QOI_OP_RUN | (run - 1)); run = 0; }
+            continue;
+        }
+        if (run) { *o++ = (unsigned char)(ENG_QOI_OP_RUN | (run - 1)); run = 0; }
+
+        int hi = eng_qoi_hash(c[0], c[1], c[2], c[3]);
+        if (memcmp(index[hi], c, 4) == 0) {
+            *o++ = (unsigned char)(ENG_QOI_OP_INDEX | hi);
+        } else {
+            memcpy(index[hi], c, 4);
+            if (c[3] == prev[3]) {
+                signed char dr = (signed char)(c[0] - prev[0]);
+                signed char dg = (signed char)(c[1] - prev[1]);
+                signed char db = (signed char)(c[2] - prev[2]);
+                signed char dr_dg = (signed char)(dr - dg);
+                signed char db_dg = (signed char)(db - dg);
+                if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+                    *o++ = (unsigned char)(ENG_QOI_OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2));
+                } else if (dg > -33 && dg < 32 && dr_dg > -9 && dr_dg < 8 && db_dg > -9 && db_dg < 8) {
+                    *o++ = (unsigned char)(ENG_QOI_OP_LUMA | (dg + 32));
+                    *o++ = (unsigned char)((dr_dg + 8) << 4 | (db_dg + 8));
+                } else {
+                    *o++ = ENG_QOI_OP_RGB;
+                    *o++ = c[0]; *o++ = c[1]; *o++ = c[2];
+                }
+            } else {
+                *o++ = ENG_QOI_OP_RGBA;
+                memcpy(o, c, 4);
+                o += 4;
+            }
+        }
+        memcpy(prev, c, 4);
+    }
+    static const unsigned char end[ENG_QOI_END_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+    memcpy(o, end, sizeof(end));
+    o += sizeof(end);
+    *out_size = (size_t)(o - out);
+    return out;
+}
+
+/* ── LZ4 ブロック エンコード (貪欲法, 4 byte ハッシュ) ──*/
+#define HASH_BITS 16
+
+static uint32_t hash4(const unsigned char* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+static unsigned char* put_len(unsigned char* o, size_t len) {
+    for (; len >= 255; len -= 255) *o++ = 255;
+    *o++ = (unsigned char)len;
+    return o;
+}
+
+static unsigned char* put_seq(unsigned char* o, const unsigned char* lit, size_t lit_len,
+                              size_t off, size_t match_len) {
+    unsigned char* token = o++;
+    *token = (unsigned char)((lit_len >= 15 ? 15 : lit_len) << 4);
+    if (lit_len >= 15) o = put_len(o, lit_len - 15);
+    memcpy(o, lit, lit_len);
+    o += lit_len;
+    if (match_len) {
+        *o++ = (unsigned char)(off & 0xff);
+        *o++ = (unsigned char)(off >> 8);
+        size_t ml = match_len - ENG_LZ4_MIN_MATCH;
+        *token |= (unsigned char)(ml >= 15 ? 15 : ml);
+        if (ml >= 15) o = put_len(o, ml - 15);
+    }
+    return o;
+}
+
+static unsigned char* encode_lz4(const unsigned char* src, size_t n, size_t* out_size) {
+    size_t cap = n + n / 255 + 16;
+    unsigned char* out = (unsigned char*)malloc(cap);
+    uint32_t*      tab = (uint32_t*)calloc((size_t)1 << HASH_BITS, sizeof(uint32_t));
+    if (!out || !tab) { free(out); free(tab); return NULL; }
+
+    unsigned char*       o      = out;
+    const unsigned char* anchor = src;
+    const unsigned char* ip     = src;
+    if (n > ENG_LZ4_MF_LIMIT) {
+        const unsigned char* mflimit  = src + n - ENG_LZ4_MF_LIMIT;
+        const unsigned char* matchlim = src + n - ENG_LZ4_LAST_LITERALS;
+        while (ip < mflimit) {
+            uint32_t             hv   = hash4(ip);
+            const unsigned char* cand = src + tab[hv];
+            tab[hv] = (uint32_t)(ip - src);
+            if (cand >= ip || (size_t)(ip - cand) > ENG_LZ4_MAX_OFFSET || memcmp(cand, ip, 4) != 0) {
+                ++ip;
+                continue;
+            }
+            const unsigned char* e = ip + 4;
+            const unsigned char* m = cand + 4;
+            while (e < matchlim && *e == *m) { ++e; ++m; }
+            o = put_seq(o, anchor, (size_t)(ip - anchor), (size_t)(ip - cand), (size_t)(e - ip));
+            ip = anchor = e;
+        }
+    }
+    o = put_seq(o, anchor, (size_t)(src + n - anchor), 0, 0);
+    free(tab);
+    *out_size = (size_t)(o - out);
+    return out;
+}
+
+/* ── 変換 ───────────────────────────────────────────────*/
+static int write_file(const char* path, const void* a, size_t na, const void* b, size_t nb) {
+    FILE* f = fopen(path, "wb");
+    if (!f) { fprintf(stderr, "書き込み失敗: %s\n", path); return 0; }
+    fwrite(a, 1, na, f);
+    if (nb) fwrite(b, 1, nb, f);
+    int ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+static void out_path(char* dst, size_t cap, const char* src, const char* ext) {
+    snprintf(dst, cap, "%s", src);
+    char* dot   = strrchr(dst, '.');
+    char* slash = strrchr(dst, '/');
+    if (dot && (!slash || dot > slash)) *dot = '\0';
+    size_t n = strlen(dst);
+    snprintf(dst + n, cap - n, "%s", ext);
+}
+
+static int convert(const char* path, int lz4) {
+    int w, h, ch;
+    unsigned char* px = stbi_load(path, &w, &h, &ch, 4);
+    if (!px) {
+        fprintf(stderr, "画像読込失敗: %s — %s\n", path, stbi_failure_reason());
+        return 0;
+    }
+    size_t raw = (size_t)w * (size_t)h * 4, n = 0;
+    unsigned char* enc = lz4 ? encode_lz4(px, raw, &n) : encode_qoi(px, w, h, &n);
+    stbi_image_free(px);
+    if (!enc) { fprintf(stderr, "メモリ不足: %s\n", path); return 0; }
+
+    char dst[1024];
+    out_path(dst, sizeof(dst), path, lz4 ? ".hjlz" : ".qoi");
+    int ok;
+    if (lz4) {
+        ENG_HjlzHeader hdr = { ENG_HJLZ_MAGIC, ENG_HJLZ_VERSION, (uint32_t)w, (uint32_t)h, n };
+        ok = write_file(dst, &hdr, sizeof(hdr), enc, n);
+        n += sizeof(hdr);
+    } else {
+        ok = write_file(dst, enc, n, NULL, 0);
+    }
+    free(enc);
+    if (ok) printf("%s → %s (%dx%d, %.1f KB)\n", path, dst, w, h, (double)n / 1024.0);
+    return ok;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 3 || (strcmp(argv[1], "qoi") != 0 && strcmp(argv[1], "lz4") != 0)) {
+        fprintf(stderr, "使い方: %s qoi|lz4 画像.png ...\n", argv[0]);
+        return 2;
+    }
+    int lz4 = strcmp(argv[1], "lz4") == 0;
+    int ok  = 1;
+    for (int i = 2; i < argc; ++i) ok &= convert(argv[i], lz4);
+    return ok ? 0 : 1;
+}